@@ -0,0 +1,52 @@
+# Times CXX FLAGS on a translation unit containing nothing but an #include of
+# each of HEADERS, after a baseline run on an empty translation unit, and
+# prints the fastest of REPEAT runs for each.
+#
+# Invoked by the compile_time_benchmark target; see CMakeLists.txt.
+
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+# Sets ${out_var} to the fastest of REPEAT compilations of source, in
+# microseconds
+function(time_compile source out_var)
+    set(best "")
+    foreach(run RANGE 1 ${REPEAT})
+        string(TIMESTAMP start "%s%f")
+        execute_process(COMMAND "${CXX}" ${FLAGS} "${source}"
+            RESULT_VARIABLE result
+            ERROR_VARIABLE errors
+            OUTPUT_QUIET)
+        string(TIMESTAMP stop "%s%f")
+        if (NOT result EQUAL 0)
+            message(FATAL_ERROR "Failed to compile ${source}:\n${errors}")
+        endif()
+        math(EXPR elapsed "${stop} - ${start}")
+        if (best STREQUAL "" OR elapsed LESS best)
+            set(best ${elapsed})
+        endif()
+    endforeach()
+    set(${out_var} ${best} PARENT_SCOPE)
+endfunction()
+
+function(format_ms micros out_var)
+    math(EXPR whole "${micros} / 1000")
+    math(EXPR frac "(${micros} % 1000) / 10")
+    if (frac LESS 10)
+        set(frac "0${frac}")
+    endif()
+    set(${out_var} "${whole}.${frac}" PARENT_SCOPE)
+endfunction()
+
+file(WRITE "${WORK_DIR}/baseline.cpp" "")
+time_compile("${WORK_DIR}/baseline.cpp" baseline)
+format_ms(${baseline} baseline_ms)
+message("empty translation unit: ${baseline_ms} ms")
+
+foreach(header IN LISTS HEADERS)
+    string(MAKE_C_IDENTIFIER "${header}" name)
+    file(WRITE "${WORK_DIR}/${name}.cpp" "#include <${header}>\n")
+    time_compile("${WORK_DIR}/${name}.cpp" total)
+    math(EXPR cost "${total} - ${baseline}")
+    format_ms(${cost} cost_ms)
+    message("${header}: +${cost_ms} ms")
+endforeach()
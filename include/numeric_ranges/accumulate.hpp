@@ -0,0 +1,420 @@
+// numeric_ranges/accumulate.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_ACCUMULATE_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_ACCUMULATE_HPP_INCLUDED
+
+#include "core.hpp"
+#include "dispatch.hpp"
+#include "saturating.hpp"
+#include "segmented.hpp"
+#include "strided_span.hpp"
+
+#include <limits>
+
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+#include <immintrin.h>
+#endif
+
+namespace tcb {
+inline namespace ranges {
+
+namespace detail {
+
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+// Loads four floats or 32-bit integers, converted to doubles or sign- or
+// zero-extended to 64 bits
+template <typename E>
+TCB_NUMERIC_RANGES_TARGET_AVX2 TCB_NUMERIC_RANGES_ALWAYS_INLINE
+auto widen4_avx2(const E* p)
+{
+    if constexpr (std::is_same_v<E, float>) {
+        return _mm256_cvtps_pd(_mm_loadu_ps(p));
+    } else if constexpr (std::is_signed_v<E>) {
+        return _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    } else {
+        return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    }
+}
+
+TCB_NUMERIC_RANGES_TARGET_AVX2 TCB_NUMERIC_RANGES_ALWAYS_INLINE
+__m256d add4_avx2(__m256d x, __m256d y) { return _mm256_add_pd(x, y); }
+
+TCB_NUMERIC_RANGES_TARGET_AVX2 TCB_NUMERIC_RANGES_ALWAYS_INLINE
+__m256i add4_avx2(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+
+// The sum of the four lanes of a vector of doubles or 64-bit integers
+template <typename A, typename V>
+TCB_NUMERIC_RANGES_TARGET_AVX2 TCB_NUMERIC_RANGES_ALWAYS_INLINE
+A horizontal_sum_avx2(V v)
+{
+    if constexpr (std::is_floating_point_v<A>) {
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, v);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    } else {
+        alignas(32) std::uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+        return static_cast<A>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    }
+}
+
+// Sum of floats in double lanes, or of 32-bit integers in 64-bit lanes,
+// converting four elements at a time in-register (vcvtps2pd, vpmovsxdq or
+// vpmovzxdq) into four independent vector accumulators. The loop compilers
+// vectorise from sum_kernel for these pairs keeps too few accumulators to
+// hide the conversions, and runs at around half the bandwidth of a
+// same-type sum.
+template <typename A, typename E>
+TCB_NUMERIC_RANGES_TARGET_AVX2
+A widened_sum_avx2(const E* data, std::ptrdiff_t n)
+{
+    using V = decltype(widen4_avx2(data));
+
+    V acc0{}, acc1{}, acc2{}, acc3{};
+    std::ptrdiff_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = add4_avx2(acc0, widen4_avx2(data + i));
+        acc1 = add4_avx2(acc1, widen4_avx2(data + i + 4));
+        acc2 = add4_avx2(acc2, widen4_avx2(data + i + 8));
+        acc3 = add4_avx2(acc3, widen4_avx2(data + i + 12));
+    }
+
+    A sum = horizontal_sum_avx2<A>(add4_avx2(add4_avx2(acc0, acc1), add4_avx2(acc2, acc3)));
+    for (; i < n; ++i) {
+        sum += static_cast<A>(data[i]);
+    }
+    return sum;
+}
+#endif
+
+// Sum of n elements in kernel_lanes<A> independent accumulators of type A.
+// Widening pairs use widened_sum_avx2 in the vector tiers; AVX-512's wider
+// conversions measured no faster, so that tier uses it too.
+template <typename A>
+struct sum_kernel {
+    template <simd_isa Isa, typename E>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static A run(const E* data, std::ptrdiff_t n)
+    {
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+        if constexpr (Isa != simd_isa::scalar && is_widening_pair_v<E, A>) {
+            return widened_sum_avx2<A>(data, n);
+        }
+#endif
+        constexpr std::ptrdiff_t L = kernel_lanes<A>;
+
+        A acc[L] = {};
+        std::ptrdiff_t i = 0;
+        for (; i + L <= n; i += L) {
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                acc[j] += static_cast<A>(data[i + j]);
+            }
+        }
+
+        A sum = A{};
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            sum += acc[j];
+        }
+        for (; i < n; ++i) {
+            sum += static_cast<A>(data[i]);
+        }
+        return sum;
+    }
+};
+
+// As sum_kernel, for n elements a fixed stride apart. The loads of each step
+// are independent of one another, so the vector tiers can gather them.
+template <typename A>
+struct strided_sum_kernel {
+    template <simd_isa, typename E>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static A run(strided_elements<E> data, std::ptrdiff_t n)
+    {
+        constexpr std::ptrdiff_t L = kernel_lanes<A>;
+
+        A acc[L] = {};
+        std::ptrdiff_t i = 0;
+        for (; i + L <= n; i += L) {
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                acc[j] += static_cast<A>(data[i + j]);
+            }
+        }
+
+        A sum = A{};
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            sum += acc[j];
+        }
+        for (; i < n; ++i) {
+            sum += static_cast<A>(data[i]);
+        }
+        return sum;
+    }
+};
+
+#if defined(__SIZEOF_INT128__)
+// Exact sum of n integers of at most 64 bits, modulo 2^128. Each element is
+// split into its high and low 32-bit halves, which are summed in separate
+// 64-bit lanes: plain adds and shifts, which vectorise, where a 128-bit add
+// needs a carry chain per element. Signed elements are first offset by
+// 2^63 (flipping the sign bit), so that their halves are unsigned, and the
+// offsets subtracted at the end. A lane can absorb 2^32 halves before it
+// could wrap, after which the lanes are flushed into the 128-bit total.
+struct int128_sum_kernel {
+    template <simd_isa, typename E>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static uint128_t run(const E* data, std::ptrdiff_t n)
+    {
+        constexpr std::ptrdiff_t L = kernel_lanes<std::uint64_t>;
+        constexpr std::ptrdiff_t chunk = L * (std::ptrdiff_t(1) << 32);
+        constexpr std::uint64_t bias = std::is_signed_v<E> ? std::uint64_t(1) << 63 : 0;
+
+        uint128_t total = 0;
+        std::ptrdiff_t i = 0;
+        while (i + L <= n) {
+            std::uint64_t lo[L] = {};
+            std::uint64_t hi[L] = {};
+            const std::ptrdiff_t start = i;
+            const std::ptrdiff_t stop = n - i > chunk ? i + chunk : n;
+            for (; i + L <= stop; i += L) {
+                for (std::ptrdiff_t j = 0; j < L; ++j) {
+                    // sign-extends signed elements
+                    const auto u = static_cast<std::uint64_t>(data[i + j]) ^ bias;
+                    lo[j] += u & 0xffffffff;
+                    hi[j] += u >> 32;
+                }
+            }
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                total += lo[j];
+                total += uint128_t(hi[j]) << 32;
+            }
+            total -= uint128_t(bias) * static_cast<std::uint64_t>(i - start);
+        }
+
+        for (; i < n; ++i) {
+            total += static_cast<uint128_t>(data[i]);
+        }
+        return total;
+    }
+};
+#endif
+
+// init plus the n elements of data, each addition clamped to the range of
+// T, for 8- and 16-bit elements. Saturation makes the sum order-dependent,
+// so it cannot be split across lanes; instead each block is checked first:
+// the sums of its positive and of its negative elements are taken in
+// lanes, and if the former could be added to the running total without
+// passing the maximum of T, and the latter without passing the minimum,
+// then no partial sum within the block would be clamped and it is added as
+// an ordinary sum. Only blocks which might saturate are added element by
+// element.
+template <typename T>
+struct saturating_sum_kernel {
+    template <simd_isa, typename E>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static T run(const E* data, std::ptrdiff_t n, T init)
+    {
+        constexpr std::ptrdiff_t B = 256;
+        constexpr std::ptrdiff_t L = kernel_lanes<std::int32_t>;
+        constexpr auto lo = static_cast<std::uint64_t>((std::numeric_limits<T>::min)());
+        constexpr auto hi = static_cast<std::uint64_t>((std::numeric_limits<T>::max)());
+
+        std::ptrdiff_t i = 0;
+        for (; i + B <= n; i += B) {
+            std::int32_t pos[L] = {};
+            std::int32_t neg[L] = {};
+            for (std::ptrdiff_t k = 0; k < B; k += L) {
+                for (std::ptrdiff_t j = 0; j < L; ++j) {
+                    const std::int32_t x = data[i + k + j];
+                    pos[j] += x > 0 ? x : 0;
+                    neg[j] += x < 0 ? x : 0;
+                }
+            }
+            std::int32_t up = 0, down = 0;
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                up += pos[j];
+                down -= neg[j];
+            }
+
+            // The room above and below the total, computed modulo 2^64
+            const auto state = static_cast<std::uint64_t>(init);
+            if (static_cast<std::uint64_t>(up) <= hi - state &&
+                static_cast<std::uint64_t>(down) <= state - lo) {
+                init = wrapping_add(init, static_cast<std::uint64_t>(std::int64_t(up) - down));
+            } else {
+                for (std::ptrdiff_t j = 0; j < B; ++j) {
+                    init = saturating_add(init, static_cast<T>(data[i + j]));
+                }
+            }
+        }
+        for (; i < n; ++i) {
+            init = saturating_add(init, static_cast<T>(data[i]));
+        }
+        return init;
+    }
+};
+
+// Total size of the ranges [first, last), for reserving space for their
+// concatenation
+template <typename I, typename S>
+constexpr std::size_t concatenated_size(I first, S last)
+{
+    std::size_t total = 0;
+    for (; first != last; ++first) {
+        total += static_cast<std::size_t>(rng::size(*first));
+    }
+    return total;
+}
+
+// True for std::basic_string, and string classes like it, whose += with
+// another string appends
+template <typename T, typename = void>
+inline constexpr bool is_appendable_string_v = false;
+
+template <typename T>
+inline constexpr bool is_appendable_string_v<T, std::void_t<
+    typename T::traits_type,
+    decltype(std::declval<T&>().reserve(std::size_t{})),
+    decltype(std::declval<T&>().append(std::declval<const T&>()))>> = true;
+
+// accumulate, and (with Reassociate) reduce, which may also split
+// floating-point sums across SIMD lanes
+template <bool Reassociate>
+struct basic_accumulate_fn {
+private:
+    template <typename I, typename S, typename T, typename Op, typename Proj>
+    static constexpr T impl(I first, S last, T init, Op& op, Proj& proj)
+    {
+        // Concatenating strings: sum the lengths first, so that the result
+        // is allocated once rather than regrown as it is appended to
+        if constexpr (is_appendable_string_v<T> &&
+                      is_std_op_v<std::plus, Op, T> &&
+                      std::is_same_v<Proj, _std::identity> &&
+                      _std::forward_iterator<I> &&
+                      rng::sized_range<_std::iter_reference_t<I>>) {
+            reserve_more(init, concatenated_size(first, last));
+        }
+
+        if constexpr (is_contiguous_sized_v<I, S> && is_int128_v<T> &&
+                      is_lane_integer_v<_std::iter_value_t<I>> &&
+                      sizeof(_std::iter_value_t<I>) <= 8 &&
+                      is_std_op_v<std::plus, Op, T> &&
+                      std::is_same_v<Proj, _std::identity>) {
+#if defined(__SIZEOF_INT128__)
+            // 64-bit (or narrower) integers summed exactly into a 128-bit total
+            if (!detail::is_constant_evaluated()) {
+                const auto n = static_cast<std::ptrdiff_t>(last - first);
+                if (n == 0) {
+                    return init;
+                }
+                return static_cast<T>(static_cast<uint128_t>(init) +
+                    dispatch<int128_sum_kernel>(std::addressof(*first), n));
+            }
+#endif
+        } else if constexpr (is_contiguous_sized_v<I, S> &&
+                             is_lane_summable_v<Reassociate, _std::iter_value_t<I>, T> &&
+                             is_std_op_v<std::plus, Op, T> &&
+                             std::is_same_v<Proj, _std::identity>) {
+            if (!detail::is_constant_evaluated()) {
+                using A = lane_accumulator_t<T>;
+                const auto n = static_cast<std::ptrdiff_t>(last - first);
+                if (n == 0) {
+                    return init;
+                }
+                return static_cast<T>(static_cast<A>(init) +
+                    dispatch<sum_kernel<A>>(std::addressof(*first), n));
+            }
+        } else if constexpr (is_contiguous_sized_v<I, S> &&
+                             is_narrow_integer_v<_std::iter_value_t<I>> &&
+                             is_lane_integer_v<T> && sizeof(T) <= 8 &&
+                             std::is_signed_v<_std::iter_value_t<I>> == std::is_signed_v<T> &&
+                             (std::is_same_v<_std::iter_value_t<I>, T> || sizeof(T) >= sizeof(int)) &&
+                             is_std_op_v<saturating_plus, Op, T> &&
+                             std::is_same_v<Proj, _std::identity>) {
+            // Saturating sums of 8- and 16-bit integers, checked a block at
+            // a time. The conditions ensure that each element converts to
+            // T unchanged, as the op would convert it.
+            if (!detail::is_constant_evaluated()) {
+                const auto n = static_cast<std::ptrdiff_t>(last - first);
+                if (n == 0) {
+                    return init;
+                }
+                return dispatch<saturating_sum_kernel<T>>(std::addressof(*first), n, init);
+            }
+        } else if constexpr (is_strided_projection_v<I, S, Proj> &&
+                             is_lane_summable_v<Reassociate, strided_value_t<I, Proj>, T> &&
+                             is_std_op_v<std::plus, Op, T>) {
+            // A strided_span, or a field of an array of structs
+            if (!detail::is_constant_evaluated()) {
+                using A = lane_accumulator_t<T>;
+                const auto n = last - first;
+                if (n == 0) {
+                    return init;
+                }
+                return static_cast<T>(static_cast<A>(init) +
+                    dispatch<strided_sum_kernel<A>>(strided_elements_of(first, proj), n));
+            }
+        } else if constexpr (is_segmented_v<I, S>) {
+            if (!detail::is_constant_evaluated()) {
+                for_each_segment(std::move(first), std::move(last), [&](auto* p, auto* q) {
+                    init = impl(p, q, std::move(init), op, proj);
+                });
+                return init;
+            }
+        }
+
+        while (first != last) {
+            accumulate_into(op, init, _std::invoke(proj, *first));
+            ++first;
+        }
+
+        return init;
+    }
+
+public:
+    template <typename I, typename S,
+        typename T = _std::iter_value_t<I>,
+        typename Op = std::plus<>,
+        typename Proj = _std::identity>
+    constexpr auto operator()(I first, S last, T init = T{},
+                              Op op = Op{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<_std::input_iterator<I> && _std::sentinel_for<S, I>, T>
+    {
+        return impl(std::move(first), std::move(last), std::move(init), op, proj);
+    }
+
+    template <typename R,
+        typename T = rng::range_value_t<R>,
+        typename Op = std::plus<>,
+        typename Proj = _std::identity>
+    constexpr auto operator()(R&& r, T init = T{},
+                              Op op = Op{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<rng::input_range<R>, T>
+    {
+        if constexpr (is_segmented_range_v<R>) {
+            if (!detail::is_constant_evaluated()) {
+                for_each_segment(r, [&](auto* p, auto* q) {
+                    init = impl(p, q, std::move(init), op, proj);
+                });
+                return init;
+            }
+        }
+        return impl(rng::begin(r), rng::end(r), std::move(init), op, proj);
+    }
+};
+
+using accumulate_fn = basic_accumulate_fn<false>;
+using reduce_fn = basic_accumulate_fn<true>;
+
+} // detail
+
+inline constexpr auto accumulate = detail::accumulate_fn{};
+
+inline constexpr auto reduce = detail::reduce_fn{};
+
+}}
+
+#endif
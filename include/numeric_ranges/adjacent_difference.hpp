@@ -0,0 +1,335 @@
+// numeric_ranges/adjacent_difference.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_ADJACENT_DIFFERENCE_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_ADJACENT_DIFFERENCE_HPP_INCLUDED
+
+#include "core.hpp"
+#include "dispatch.hpp"
+#include "saturating.hpp"
+#include "segmented.hpp"
+#include "streaming_store.hpp"
+
+#ifndef TCB_NUMERIC_RANGES_USE_NANORANGE
+#include <algorithm>
+#endif
+
+#include <optional>
+
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+#include <immintrin.h>
+#endif
+
+namespace tcb {
+inline namespace ranges {
+
+template <typename I, typename O>
+using adjacent_difference_result = rng::copy_result<I, O>;
+
+namespace detail {
+
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+// Saturating sums (or with Minus, differences) of adjacent 8- or 16-bit
+// integers, out[k] = in[k] + in[k - 1] for k in [i0, i), 32 bytes at a
+// time with paddsw, psubusb and so on, from the back. Returns i0.
+template <bool Minus, typename E>
+TCB_NUMERIC_RANGES_TARGET_AVX2
+std::ptrdiff_t adjacent_saturate_avx2(const E* in, E* out, std::ptrdiff_t i)
+{
+    constexpr std::ptrdiff_t L = 32 / sizeof(E);
+    constexpr bool is_signed = std::is_signed_v<E>;
+
+    while (i - L >= 1) {
+        i -= L;
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i - 1));
+        __m256i r;
+        if constexpr (sizeof(E) == 1 && is_signed) {
+            r = Minus ? _mm256_subs_epi8(x, y) : _mm256_adds_epi8(x, y);
+        } else if constexpr (sizeof(E) == 1) {
+            r = Minus ? _mm256_subs_epu8(x, y) : _mm256_adds_epu8(x, y);
+        } else if constexpr (is_signed) {
+            r = Minus ? _mm256_subs_epi16(x, y) : _mm256_adds_epi16(x, y);
+        } else {
+            r = Minus ? _mm256_subs_epu16(x, y) : _mm256_adds_epu16(x, y);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), r);
+    }
+    return i;
+}
+#endif
+
+// Writes in[i] - in[i - 1] for i > 0 and in[0] for i = 0, or with Op a
+// saturating op, the clamped difference or sum. Blocks are processed from
+// the back, each read in full before it is written, so out may be equal to
+// in.
+template <typename Op = std::minus<>>
+struct adjacent_difference_kernel {
+    template <typename E>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static E apply(E x, E y)
+    {
+        if constexpr (is_std_op_v<saturating_plus, Op, E>) {
+            return saturating_add(x, y);
+        } else if constexpr (is_std_op_v<saturating_minus, Op, E>) {
+            return saturating_sub(x, y);
+        } else {
+            return static_cast<E>(x - y);
+        }
+    }
+
+    template <simd_isa Isa, typename E>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static void run(const E* in, E* out, std::ptrdiff_t n)
+    {
+        constexpr std::ptrdiff_t L = kernel_lanes<E>;
+
+        const E first = in[0];
+        std::ptrdiff_t i = n;
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+        // Compilers widen, clamp and narrow the saturating ops rather than
+        // use the saturating instructions
+        if constexpr (Isa != simd_isa::scalar && is_saturating_op_v<Op, E>) {
+            i = adjacent_saturate_avx2<is_std_op_v<saturating_minus, Op, E>>(in, out, i);
+        }
+#endif
+        while (i - L >= 1) {
+            i -= L;
+            E diff[L];
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                diff[j] = apply(in[i + j], in[i + j - 1]);
+            }
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                out[i + j] = diff[j];
+            }
+        }
+        while (--i >= 1) {
+            out[i] = apply(in[i], in[i - 1]);
+        }
+        out[0] = first;
+    }
+};
+
+struct adjacent_difference_fn {
+private:
+    template <typename I, typename S, typename O, typename Op, typename Proj>
+    static constexpr auto impl(I first, S last, O ofirst, Op& op, Proj& proj)
+        -> adjacent_difference_result<I, O>
+    {
+        if constexpr (is_streaming_store_v<O>) {
+            return stream(std::move(first), std::move(last), ofirst, op, proj);
+        } else if constexpr (is_back_insert_iterator_v<O>) {
+            return append(std::move(first), std::move(last), std::move(ofirst), op, proj);
+        } else if constexpr (is_contiguous_sized_v<I, S> && _std::contiguous_iterator<O>) {
+            using E = _std::iter_value_t<I>;
+            if constexpr (std::is_same_v<_std::iter_value_t<O>, E> &&
+                          std::is_arithmetic_v<E> && !std::is_same_v<E, bool> &&
+                          (is_std_op_v<std::minus, Op, E> || is_saturating_op_v<Op, E>) &&
+                          std::is_same_v<Proj, _std::identity>) {
+                if (!detail::is_constant_evaluated()) {
+                    const auto n = static_cast<std::ptrdiff_t>(last - first);
+                    if (n > 0) {
+                        const E* in = std::addressof(*first);
+                        E* out = std::addressof(*ofirst);
+                        if (same_or_disjoint(in, out, n)) {
+                            dispatch<adjacent_difference_kernel<Op>>(in, out, n);
+                            return {first + n, ofirst + n};
+                        }
+                    }
+                }
+            }
+        } else if constexpr (is_segmented_v<I, S>) {
+            if (!detail::is_constant_evaluated()) {
+                auto out = difference_segments<_std::iter_value_t<I>>([&](auto f) {
+                    for_each_segment(first, last, f);
+                }, std::move(ofirst), op, proj);
+                return {std::move(last), std::move(out)};
+            }
+        }
+
+        return sequential(std::move(first), std::move(last), std::move(ofirst), op, proj);
+    }
+
+    template <typename I, typename S, typename O, typename Op, typename Proj>
+    static constexpr auto sequential(I first, S last, O ofirst, Op& op, Proj& proj)
+        -> adjacent_difference_result<I, O>
+    {
+        if (first == last) {
+            return {std::move(first), std::move(ofirst)};
+        }
+
+        auto prev = _std::invoke(proj, *first);
+        *ofirst = prev;
+
+        while (++first != last) {
+            auto cur = _std::invoke(proj, *first);
+            *++ofirst = _std::invoke(op, cur, prev); // std::move(prev)???
+            prev = std::move(cur);
+        }
+
+        ++ofirst;
+
+        return {std::move(first), std::move(ofirst)};
+    }
+
+    template <typename I, typename S, typename E, typename Op, typename Proj>
+    static constexpr auto stream(I first, S last, streaming_store_iterator<E> ofirst,
+                                 Op& op, Proj& proj)
+        -> adjacent_difference_result<I, streaming_store_iterator<E>>
+    {
+        if constexpr (is_contiguous_sized_v<I, S> &&
+                      std::is_same_v<_std::iter_value_t<I>, E> &&
+                      std::is_arithmetic_v<E> && !std::is_same_v<E, bool> &&
+                      is_std_op_v<std::minus, Op, E> &&
+                      std::is_same_v<Proj, _std::identity>) {
+            const auto n = static_cast<std::ptrdiff_t>(last - first);
+            if (!detail::is_constant_evaluated() && n > 0 && ofirst.streams(n)) {
+                const E* in = std::addressof(*first);
+                if (same_or_disjoint(in, ofirst.base(), n)) {
+                    // The last input of each block is saved before the block
+                    // is written, since in place it is then overwritten
+                    E prev{};
+                    stream_blocks(ofirst.base(), n,
+                                  [in, &prev](E* stage, std::ptrdiff_t i, std::ptrdiff_t m) {
+                        dispatch<adjacent_difference_kernel<>>(in + i, stage, m);
+                        if (i > 0) {
+                            stage[0] = static_cast<E>(in[i] - prev);
+                        }
+                        prev = in[i + m - 1];
+                    });
+                    return {first + n, ofirst + n};
+                }
+            }
+        }
+
+        auto res = impl(std::move(first), std::move(last), ofirst.base(), op, proj);
+        return {std::move(res.in), ofirst + (res.out - ofirst.base())};
+    }
+
+    // Differences a segmented input, each of whose segments walk visits,
+    // carrying the last element of each segment into the next
+    template <typename E, typename Walk, typename O, typename Op, typename Proj>
+    static O difference_segments(Walk walk, O out, Op& op, Proj& proj)
+    {
+        if constexpr (_std::contiguous_iterator<O> &&
+                      std::is_same_v<_std::iter_value_t<O>, E> &&
+                      std::is_arithmetic_v<E> && !std::is_same_v<E, bool> &&
+                      is_std_op_v<std::minus, Op, E> &&
+                      std::is_same_v<Proj, _std::identity>) {
+            bool started = false;
+            E prev{};
+            walk([&](const E* p, const E* q) {
+                const auto n = q - p;
+                E* o = std::addressof(*out);
+                // Read before the segment is written, which may be in place
+                const E head = p[0];
+                const E tail = p[n - 1];
+                if (same_or_disjoint(p, o, n)) {
+                    dispatch<adjacent_difference_kernel<>>(p, o, n);
+                } else {
+                    sequential(p, q, o, op, proj);
+                }
+                if (started) {
+                    o[0] = static_cast<E>(head - prev);
+                }
+                started = true;
+                prev = tail;
+                out += n;
+            });
+            return out;
+        } else {
+            using V = std::remove_cv_t<std::remove_reference_t<std::invoke_result_t<Proj&, E&>>>;
+            std::optional<V> prev;
+            walk([&](auto* p, auto* q) {
+                if (!prev) {
+                    prev.emplace(_std::invoke(proj, *p));
+                    *out = *prev;
+                    ++out;
+                    ++p;
+                }
+                for (; p != q; ++p) {
+                    auto cur = _std::invoke(proj, *p);
+                    *out = _std::invoke(op, cur, *prev);
+                    ++out;
+                    *prev = std::move(cur);
+                }
+            });
+            return out;
+        }
+    }
+
+    // Appending to a container: make room for the output up front, and for
+    // vectors of arithmetic values write it through a pointer so that the
+    // contiguous fast path applies
+    template <typename I, typename S, typename C, typename Op, typename Proj>
+    static constexpr auto append(I first, S last, std::back_insert_iterator<C> ofirst,
+                                 Op& op, Proj& proj)
+        -> adjacent_difference_result<I, std::back_insert_iterator<C>>
+    {
+        if constexpr (_std::sized_sentinel_for<S, I>) {
+            if (!detail::is_constant_evaluated()) {
+                using R = std::invoke_result_t<Proj&, _std::iter_reference_t<I>>;
+                C& c = back_insert_container(ofirst);
+                const auto n = static_cast<std::size_t>(last - first);
+                if constexpr (is_resizable_contiguous_v<C> &&
+                              std::is_nothrow_invocable_v<Proj&, _std::iter_reference_t<I>> &&
+                              std::is_nothrow_invocable_v<Op&, R, R>) {
+                    const std::size_t old = c.size();
+                    c.resize(old + n);
+                    auto res = impl(std::move(first), std::move(last), c.data() + old, op, proj);
+                    return {std::move(res.in), std::move(ofirst)};
+                } else {
+                    reserve_more(c, n);
+                }
+            }
+        }
+
+        return sequential(std::move(first), std::move(last), std::move(ofirst), op, proj);
+    }
+
+public:
+    template <typename I, typename S, typename O,
+        typename Op = std::minus<>, typename Proj = _std::identity,
+        typename Id = std::decay_t<I>>
+    constexpr auto operator()(I&& first, S last, O ofirst,
+                              Op op = Op{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<
+        !rng::input_range<I> &&
+            _std::input_iterator<Id> && _std::sentinel_for<S, Id>,
+        adjacent_difference_result<Id, O>>
+    {
+        return impl(std::forward<I>(first), std::move(last), std::move(ofirst),
+                    op, proj);
+    }
+
+    template <typename R, typename O,
+        typename Op = std::minus<>, typename Proj = _std::identity>
+    constexpr auto operator()(R&& r, O o, Op op = Op{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<
+        rng::input_range<R>,
+        adjacent_difference_result<rng::borrowed_iterator_t<R>, O>>
+    {
+        if constexpr (has_segmented_range_traits_v<std::remove_cv_t<std::remove_reference_t<R>>> &&
+                      !is_streaming_store_v<O>) {
+            if (!detail::is_constant_evaluated()) {
+                auto out = difference_segments<rng::range_value_t<R>>([&](auto f) {
+                    for_each_segment(r, f);
+                }, std::move(o), op, proj);
+                return {segmented_end(r), std::move(out)};
+            }
+        }
+        return impl(rng::begin(r), rng::end(r), std::move(o), op, proj);
+    }
+
+};
+
+} // detail
+
+inline constexpr auto adjacent_difference = detail::adjacent_difference_fn{};
+
+}}
+
+#endif
@@ -0,0 +1,370 @@
+// numeric_ranges/checked_accumulate.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_CHECKED_ACCUMULATE_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_CHECKED_ACCUMULATE_HPP_INCLUDED
+
+#include "accumulate.hpp"
+#include "core.hpp"
+#include "dispatch.hpp"
+
+#include <limits>
+
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+#include <immintrin.h>
+#endif
+
+namespace tcb {
+inline namespace ranges {
+
+// The result of checked_accumulate and checked_inner_product: the sum
+// wrapped modulo 2^N into T, and whether the exact sum lies outside T's range
+template <typename T>
+struct checked_result {
+    T value;
+    bool overflowed;
+};
+
+namespace detail {
+
+// A 128-bit two's complement total held as two 64-bit words, so that it
+// needs no compiler support. It is exact for any sum of fewer than 2^63
+// integers of at most 64 bits.
+struct wide_total {
+    std::uint64_t lo = 0;
+    std::uint64_t hi = 0;
+
+    // Adds or subtracts hi2 * 2^64 + lo2, modulo 2^128
+    constexpr void add_parts(std::uint64_t lo2, std::uint64_t hi2)
+    {
+        lo += lo2;
+        hi += hi2 + (lo < lo2 ? 1 : 0);
+    }
+
+    constexpr void sub_parts(std::uint64_t lo2, std::uint64_t hi2)
+    {
+        hi -= hi2 + (lo < lo2 ? 1 : 0);
+        lo -= lo2;
+    }
+
+    template <typename X>
+    constexpr void add(X x)
+    {
+        // sign-extends signed values
+        const auto u = static_cast<std::uint64_t>(x);
+        if constexpr (std::is_signed_v<X>) {
+            add_parts(u, x < 0 ? ~std::uint64_t(0) : 0);
+        } else {
+            add_parts(u, 0);
+        }
+    }
+
+    template <typename T>
+    constexpr checked_result<T> result() const
+    {
+        bool fits = false;
+        if constexpr (std::is_signed_v<T>) {
+            const auto v = static_cast<std::int64_t>(lo);
+            fits = hi == (v < 0 ? ~std::uint64_t(0) : 0) &&
+                   v >= std::int64_t((std::numeric_limits<T>::min)()) &&
+                   v <= std::int64_t((std::numeric_limits<T>::max)());
+        } else {
+            fits = hi == 0 && lo <= std::uint64_t((std::numeric_limits<T>::max)());
+        }
+        return {static_cast<T>(lo), !fits};
+    }
+};
+
+template <typename T>
+inline constexpr bool is_checkable_integer_v =
+    is_lane_integer_v<T> && sizeof(T) <= 8;
+
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+// checked_dot_kernel for two arrays of the same 32-bit integer type: the
+// elements are extended in-register and multiplied with vpmuldq or
+// vpmuludq, whose 64-bit products the compilers do not form themselves.
+template <typename E>
+TCB_NUMERIC_RANGES_TARGET_AVX2
+wide_total checked_dot_avx2(const E* a, const E* b, std::ptrdiff_t n)
+{
+    constexpr std::uint64_t bias = std::is_signed_v<E> ? std::uint64_t(1) << 63 : 0;
+    constexpr std::ptrdiff_t chunk = std::ptrdiff_t(8) << 32;
+    const __m256i vbias = _mm256_set1_epi64x(static_cast<long long>(bias));
+    const __m256i mask = _mm256_set1_epi64x(0xffffffff);
+
+    wide_total total;
+    std::ptrdiff_t i = 0;
+    while (i + 8 <= n) {
+        __m256i lo0{}, lo1{}, hi0{}, hi1{};
+        const std::ptrdiff_t start = i;
+        const std::ptrdiff_t stop = n - i > chunk ? i + chunk : n;
+        for (; i + 8 <= stop; i += 8) {
+            __m256i p0, p1;
+            if constexpr (std::is_signed_v<E>) {
+                p0 = _mm256_mul_epi32(widen4_avx2(a + i), widen4_avx2(b + i));
+                p1 = _mm256_mul_epi32(widen4_avx2(a + i + 4), widen4_avx2(b + i + 4));
+            } else {
+                p0 = _mm256_mul_epu32(widen4_avx2(a + i), widen4_avx2(b + i));
+                p1 = _mm256_mul_epu32(widen4_avx2(a + i + 4), widen4_avx2(b + i + 4));
+            }
+            p0 = _mm256_xor_si256(p0, vbias);
+            p1 = _mm256_xor_si256(p1, vbias);
+            lo0 = _mm256_add_epi64(lo0, _mm256_and_si256(p0, mask));
+            lo1 = _mm256_add_epi64(lo1, _mm256_and_si256(p1, mask));
+            hi0 = _mm256_add_epi64(hi0, _mm256_srli_epi64(p0, 32));
+            hi1 = _mm256_add_epi64(hi1, _mm256_srli_epi64(p1, 32));
+        }
+
+        alignas(32) std::uint64_t lo[8];
+        alignas(32) std::uint64_t hi[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lo), lo0);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lo + 4), lo1);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(hi), hi0);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(hi + 4), hi1);
+        for (int j = 0; j < 8; ++j) {
+            total.add_parts(lo[j], 0);
+            total.add_parts(hi[j] << 32, hi[j] >> 32);
+        }
+        const auto count = static_cast<std::uint64_t>(i - start);
+        if constexpr (bias != 0) {
+            total.sub_parts(count << 63, count >> 1);
+        }
+    }
+
+    using P = std::conditional_t<std::is_signed_v<E>, std::int64_t, std::uint64_t>;
+    for (; i < n; ++i) {
+        total.add(P(a[i]) * P(b[i]));
+    }
+    return total;
+}
+#endif
+
+// The products of two integers of at most 32 bits, and their sums, split
+// as int128_sum_kernel splits its elements: each product is exact in 64
+// bits, and its halves are summed in separate 64-bit lanes, which are
+// added into a wide_total every 2^32 products per lane. Pairs of 32-bit
+// arrays use checked_dot_avx2 in the vector tiers.
+struct checked_dot_kernel {
+    template <simd_isa Isa, typename E1, typename E2>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static wide_total run(const E1* a, const E2* b, std::ptrdiff_t n)
+    {
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+        if constexpr (Isa != simd_isa::scalar && std::is_same_v<E1, E2> && sizeof(E1) == 4) {
+            return checked_dot_avx2(a, b, n);
+        }
+#endif
+        using P = std::conditional_t<std::is_unsigned_v<E1> && std::is_unsigned_v<E2>,
+                                     std::uint64_t, std::int64_t>;
+        constexpr std::ptrdiff_t L = kernel_lanes<std::uint64_t>;
+        constexpr std::ptrdiff_t chunk = L * (std::ptrdiff_t(1) << 32);
+        constexpr std::uint64_t bias = std::is_signed_v<P> ? std::uint64_t(1) << 63 : 0;
+
+        wide_total total;
+        std::ptrdiff_t i = 0;
+        while (i + L <= n) {
+            std::uint64_t lo[L] = {};
+            std::uint64_t hi[L] = {};
+            const std::ptrdiff_t start = i;
+            const std::ptrdiff_t stop = n - i > chunk ? i + chunk : n;
+            for (; i + L <= stop; i += L) {
+                for (std::ptrdiff_t j = 0; j < L; ++j) {
+                    const auto u = static_cast<std::uint64_t>(P(a[i + j]) * P(b[i + j])) ^ bias;
+                    lo[j] += u & 0xffffffff;
+                    hi[j] += u >> 32;
+                }
+            }
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                total.add_parts(lo[j], 0);
+                total.add_parts(hi[j] << 32, hi[j] >> 32);
+            }
+            // Remove the offsets: 2^63 for each of the i - start products
+            const auto count = static_cast<std::uint64_t>(i - start);
+            if constexpr (bias != 0) {
+                total.sub_parts(count << 63, count >> 1);
+            }
+        }
+
+        for (; i < n; ++i) {
+            total.add(P(a[i]) * P(b[i]));
+        }
+        return total;
+    }
+};
+
+struct checked_accumulate_fn {
+private:
+    template <typename I, typename S, typename T, typename Proj>
+    static constexpr checked_result<T> impl(I first, S last, T init, Proj& proj)
+    {
+        using E = _std::iter_value_t<I>;
+        using R = std::remove_cv_t<std::remove_reference_t<
+            std::invoke_result_t<Proj&, _std::iter_reference_t<I>>>>;
+        static_assert(is_checkable_integer_v<T> && is_checkable_integer_v<R>,
+                      "checked_accumulate requires integers of at most 64 bits");
+
+        wide_total total;
+        total.add(init);
+
+        if constexpr (is_contiguous_sized_v<I, S> &&
+                      std::is_same_v<Proj, _std::identity> && sizeof(E) <= 4) {
+            if (!detail::is_constant_evaluated()) {
+                // At most 2^32 such elements sum exactly in 64 bits
+                constexpr std::ptrdiff_t chunk = std::ptrdiff_t(1) << 32;
+                const E* p = std::addressof(*first);
+                auto n = static_cast<std::ptrdiff_t>(last - first);
+                while (n > 0) {
+                    const std::ptrdiff_t m = n < chunk ? n : chunk;
+                    const std::uint64_t sum = dispatch<sum_kernel<std::uint64_t>>(p, m);
+                    if constexpr (std::is_signed_v<E>) {
+                        total.add(static_cast<std::int64_t>(sum));
+                    } else {
+                        total.add(sum);
+                    }
+                    p += m;
+                    n -= m;
+                }
+                return total.template result<T>();
+            }
+        }
+#if defined(__SIZEOF_INT128__)
+        else if constexpr (is_contiguous_sized_v<I, S> &&
+                           std::is_same_v<Proj, _std::identity>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = static_cast<std::ptrdiff_t>(last - first);
+                if (n > 0) {
+                    const uint128_t sum = dispatch<int128_sum_kernel>(std::addressof(*first), n);
+                    total.add_parts(static_cast<std::uint64_t>(sum),
+                                    static_cast<std::uint64_t>(sum >> 64));
+                }
+                return total.template result<T>();
+            }
+        }
+#endif
+
+        for (; first != last; ++first) {
+            total.add(_std::invoke(proj, *first));
+        }
+        return total.template result<T>();
+    }
+
+public:
+    template <typename I, typename S,
+        typename T = _std::iter_value_t<I>,
+        typename Proj = _std::identity>
+    constexpr auto operator()(I first, S last, T init = T{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<_std::input_iterator<I> && _std::sentinel_for<S, I>,
+        checked_result<T>>
+    {
+        return impl(std::move(first), std::move(last), std::move(init), proj);
+    }
+
+    template <typename R,
+        typename T = rng::range_value_t<R>,
+        typename Proj = _std::identity>
+    constexpr auto operator()(R&& r, T init = T{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<rng::input_range<R>, checked_result<T>>
+    {
+        return impl(rng::begin(r), rng::end(r), std::move(init), proj);
+    }
+};
+
+struct checked_inner_product_fn {
+private:
+    template <typename I1, typename S1, typename I2, typename S2, typename T,
+        typename Proj1, typename Proj2>
+    static constexpr checked_result<T> impl(I1 first1, S1 last1, I2 first2, S2 last2,
+                                            T init, Proj1& proj1, Proj2& proj2)
+    {
+        using R1 = std::remove_cv_t<std::remove_reference_t<
+            std::invoke_result_t<Proj1&, _std::iter_reference_t<I1>>>>;
+        using R2 = std::remove_cv_t<std::remove_reference_t<
+            std::invoke_result_t<Proj2&, _std::iter_reference_t<I2>>>>;
+        static_assert(is_checkable_integer_v<T>,
+                      "checked_inner_product requires a result of at most 64 bits");
+        static_assert(is_lane_integer_v<R1> && sizeof(R1) <= 4 &&
+                      is_lane_integer_v<R2> && sizeof(R2) <= 4,
+                      "checked_inner_product requires integers of at most 32 bits");
+        using P = std::conditional_t<std::is_unsigned_v<R1> && std::is_unsigned_v<R2>,
+                                     std::uint64_t, std::int64_t>;
+
+        wide_total total;
+        total.add(init);
+
+        if constexpr (is_contiguous_sized_v<I1, S1> &&
+                      is_contiguous_sized_v<I2, S2> &&
+                      std::is_same_v<Proj1, _std::identity> &&
+                      std::is_same_v<Proj2, _std::identity>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n1 = last1 - first1;
+                const auto n2 = last2 - first2;
+                const std::ptrdiff_t n = n1 < n2 ? n1 : n2;
+                if (n > 0) {
+                    const wide_total dot = dispatch<checked_dot_kernel>(
+                        std::addressof(*first1), std::addressof(*first2), n);
+                    total.add_parts(dot.lo, dot.hi);
+                }
+                return total.template result<T>();
+            }
+        }
+
+        for (; first1 != last1 && first2 != last2; ++first1, (void) ++first2) {
+            total.add(P(_std::invoke(proj1, *first1)) * P(_std::invoke(proj2, *first2)));
+        }
+        return total.template result<T>();
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2,
+        typename T,
+        typename Proj1 = _std::identity,
+        typename Proj2 = _std::identity>
+    constexpr auto operator()(I1 first1, S1 last1, I2 first2, S2 last2, T init,
+                              Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    -> std::enable_if_t<
+        _std::input_iterator<I1> && _std::sentinel_for<S1, I1> &&
+            _std::input_iterator<I2> && _std::sentinel_for<S2, I2>,
+        checked_result<T>>
+    {
+        return impl(std::move(first1), std::move(last1),
+                    std::move(first2), std::move(last2),
+                    std::move(init), proj1, proj2);
+    }
+
+    template <typename R1, typename R2, typename T,
+        typename Proj1 = _std::identity,
+        typename Proj2 = _std::identity>
+    constexpr auto operator()(R1&& r1, R2&& r2, T init,
+                              Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    -> std::enable_if_t<rng::input_range<R1> && rng::input_range<R2>,
+        checked_result<T>>
+    {
+        return impl(rng::begin(r1), rng::end(r1),
+                    rng::begin(r2), rng::end(r2),
+                    std::move(init), proj1, proj2);
+    }
+};
+
+} // namespace detail
+
+// checked_accumulate(r, init, proj) sums init and the (projected) integers
+// of r, returning the sum wrapped modulo 2^N into T -- what a wrapping
+// accumulate would produce -- along with whether the exact sum overflows
+// T. The check is of the exact total rather than of each partial sum, so
+// it does not depend on the order of the additions, and contiguous ranges
+// are summed in SIMD lanes with no per-element test: 32-bit and narrower
+// integers in 64-bit lanes, 64-bit integers split into halves as for a
+// __int128 accumulate. Elements and T may be any integers of up to 64 bits.
+inline constexpr auto checked_accumulate = detail::checked_accumulate_fn{};
+
+// checked_inner_product(r1, r2, init, proj1, proj2) is the same for init
+// plus the sum of products of corresponding elements, which must be
+// integers of at most 32 bits so that each product is exact in 64.
+inline constexpr auto checked_inner_product = detail::checked_inner_product_fn{};
+
+}}
+
+#endif
@@ -0,0 +1,73 @@
+// numeric_ranges/concat_reduce.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_CONCAT_REDUCE_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_CONCAT_REDUCE_HPP_INCLUDED
+
+#include "accumulate.hpp"
+#include "core.hpp"
+
+namespace tcb {
+inline namespace ranges {
+
+namespace detail {
+
+template <typename C, typename E, typename = void>
+inline constexpr bool is_insertable_range_v = false;
+
+template <typename C, typename E>
+inline constexpr bool is_insertable_range_v<C, E, std::void_t<
+    decltype(std::declval<C&>().insert(std::declval<C&>().end(),
+                                       rng::begin(std::declval<E&>()),
+                                       rng::end(std::declval<E&>())))>> = true;
+
+struct concat_reduce_fn {
+
+    template <typename I, typename S, typename C = _std::iter_value_t<I>>
+    constexpr auto operator()(I first, S last, C init = C{}) const
+    -> std::enable_if_t<
+        _std::input_iterator<I> && _std::sentinel_for<S, I> &&
+            rng::input_range<_std::iter_reference_t<I>> &&
+            is_insertable_range_v<C, _std::iter_reference_t<I>>,
+        C>
+    {
+        if constexpr (has_reserve_v<C> && _std::forward_iterator<I> &&
+                      rng::sized_range<_std::iter_reference_t<I>>) {
+            reserve_more(init, concatenated_size(first, last));
+        }
+
+        for (; first != last; ++first) {
+            auto&& elem = *first;
+            init.insert(init.end(), rng::begin(elem), rng::end(elem));
+        }
+
+        return init;
+    }
+
+    template <typename R, typename C = rng::range_value_t<R>>
+    constexpr auto operator()(R&& r, C init = C{}) const
+    -> std::enable_if_t<
+        rng::input_range<R> && rng::input_range<rng::range_reference_t<R>> &&
+            is_insertable_range_v<C, rng::range_reference_t<R>>,
+        C>
+    {
+        return (*this)(rng::begin(r), rng::end(r), std::move(init));
+    }
+};
+
+} // namespace detail
+
+// concat_reduce(first, last, init) / concat_reduce(r, init) appends each of
+// a range of ranges -- strings, spans, vectors -- to the container init, by
+// default an empty container of the element type, and returns it. If the
+// elements are sized and can be read twice, their total size is computed
+// first and init is grown once, rather than reallocated repeatedly as it
+// fills.
+inline constexpr auto concat_reduce = detail::concat_reduce_fn{};
+
+}}
+
+#endif
@@ -0,0 +1,302 @@
+// numeric_ranges/core.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_CORE_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_CORE_HPP_INCLUDED
+
+#ifdef TCB_NUMERIC_RANGES_USE_NANORANGE
+#include <nanorange.hpp>
+#else
+#include <functional>
+#include <iterator>
+#include <ranges>
+#endif // USE_NANORANGE
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace tcb {
+inline namespace ranges {
+
+#ifdef TCB_NUMERIC_RANGES_USE_NANORANGE
+namespace _std = nano;
+namespace rng = nano::ranges;
+#else
+namespace _std = std;
+namespace rng = std::ranges;
+#endif
+
+// Customization point for accumulating in place. Where
+// compound_assign<Op>::apply(acc, x) is well-formed and acc is not of
+// scalar type, the algorithms call it rather than
+// acc = op(std::move(acc), x), which for accumulators such as big
+// integers, valarrays or matrices saves constructing (and often
+// allocating) a temporary for every element. A specialisation must have
+// the same effect as the assignment it replaces.
+//
+// std::plus and std::multiplies use += and *=; specialise this for other
+// operations, e.g.
+//
+//     template <>
+//     struct tcb::compound_assign<matrix_add> {
+//         static void apply(matrix& acc, const matrix& x) { acc.add(x); }
+//     };
+template <typename Op>
+struct compound_assign {};
+
+template <typename T>
+struct compound_assign<std::plus<T>> {
+    template <typename U = T>
+    static constexpr auto apply(U& acc, const U& x) -> decltype(void(acc += x))
+    {
+        acc += x;
+    }
+};
+
+template <>
+struct compound_assign<std::plus<>> {
+    template <typename A, typename X>
+    static constexpr auto apply(A& acc, X&& x)
+    -> decltype(void(acc += std::forward<X>(x)))
+    {
+        acc += std::forward<X>(x);
+    }
+};
+
+template <typename T>
+struct compound_assign<std::multiplies<T>> {
+    template <typename U = T>
+    static constexpr auto apply(U& acc, const U& x) -> decltype(void(acc *= x))
+    {
+        acc *= x;
+    }
+};
+
+template <>
+struct compound_assign<std::multiplies<>> {
+    template <typename A, typename X>
+    static constexpr auto apply(A& acc, X&& x)
+    -> decltype(void(acc *= std::forward<X>(x)))
+    {
+        acc *= std::forward<X>(x);
+    }
+};
+
+namespace detail {
+
+constexpr bool is_constant_evaluated() noexcept
+{
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#elif defined(__GNUC__) || defined(_MSC_VER)
+    return __builtin_is_constant_evaluated();
+#else
+    // Can't tell, so always take the portable path
+    return true;
+#endif
+}
+
+// True if [I, S) denotes a contiguous block of memory whose size we can
+// compute up front, which is what the lane-parallel kernels need
+template <typename I, typename S>
+inline constexpr bool is_contiguous_sized_v =
+    _std::contiguous_iterator<I> && _std::sized_sentinel_for<S, I>;
+
+template <typename Proj, typename I>
+using projected_value_t = std::remove_cv_t<std::remove_reference_t<
+    std::invoke_result_t<Proj&, _std::iter_reference_t<I>>>>;
+
+// True if Op is StdOp<void> or StdOp<V>, e.g. std::plus<> or std::plus<int>
+template <template <typename> class StdOp, typename Op, typename V>
+inline constexpr bool is_std_op_v =
+    std::is_same_v<Op, StdOp<void>> || std::is_same_v<Op, StdOp<V>>;
+
+template <typename Comp, typename V>
+inline constexpr bool is_default_less_v =
+    std::is_same_v<Comp, rng::less> || std::is_same_v<Comp, std::less<>> ||
+    std::is_same_v<Comp, std::less<V>>;
+
+// Number of independent accumulators used by the lane-parallel kernels for
+// elements of type T: enough to fill a 512-bit register, and never fewer
+// than eight so that there are enough independent dependency chains to
+// hide FP add latency.
+template <typename T>
+inline constexpr std::ptrdiff_t kernel_lanes =
+    64 / sizeof(T) > 8 ? 64 / sizeof(T) : 8;
+
+// Accumulator used by the lane-parallel kernels for a result of type T:
+// integers accumulate in the corresponding unsigned type, so the lanes
+// wrap rather than overflow, and the final result is correct modulo 2^N
+template <typename T>
+using lane_accumulator_t =
+    typename std::conditional_t<std::is_integral_v<T>,
+                                std::make_unsigned<T>,
+                                std::enable_if<true, T>>::type;
+
+template <typename T>
+inline constexpr bool is_lane_integer_v =
+    std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+// True if elements of type E may be added into a T in independent lanes:
+// always for integers, since wrapping addition is associative, but for
+// floating point only when the algorithm permits reassociation
+template <bool Reassociate, typename E, typename T>
+inline constexpr bool is_lane_summable_v =
+    (is_lane_integer_v<E> && is_lane_integer_v<T>) ||
+    (Reassociate && std::is_floating_point_v<T> && std::is_arithmetic_v<E>);
+
+// True for the element and lane accumulator types which the vector tiers
+// convert in-register: float into double, and 32-bit into 64-bit integers
+template <typename E, typename A>
+inline constexpr bool is_widening_pair_v =
+    (std::is_same_v<E, float> && std::is_same_v<A, double>) ||
+    (is_lane_integer_v<E> && sizeof(E) == 4 &&
+     std::is_integral_v<A> && std::is_unsigned_v<A> && sizeof(A) == 8);
+
+// 128-bit integers, where the compiler provides them. They are integral
+// types only in the GNU dialects, so they are named explicitly.
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+
+template <typename T>
+inline constexpr bool is_int128_v =
+    std::is_same_v<T, int128_t> || std::is_same_v<T, uint128_t>;
+#else
+template <typename T>
+inline constexpr bool is_int128_v = false;
+#endif
+
+template <typename E>
+inline constexpr bool is_narrow_integer_v =
+    std::is_integral_v<E> && !std::is_same_v<E, bool> && sizeof(E) <= 2;
+
+template <typename T>
+inline constexpr bool is_wide_integer_v =
+    std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) >= 4;
+
+// Adds modulo 2^N, sidestepping signed overflow. y is zero-extended to T if
+// it is a std::uint64_t and sign-extended if it is a std::int64_t.
+template <typename T, typename Y>
+constexpr T wrapping_add(T x, Y y)
+{
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(x) + static_cast<U>(y));
+}
+
+// The type in which Op, std::multiplies<> or std::multiplies<V>, forms the
+// product of an E1 and an E2
+template <typename Op, typename E1, typename E2>
+using product_t = std::remove_cv_t<std::remove_reference_t<
+    std::invoke_result_t<Op&, const E1&, const E2&>>>;
+
+// x * y formed in P, as product_t's Op forms it, except that an integer
+// product wraps modulo 2^N rather than overflowing. The lane kernels convert
+// the product to their accumulator only afterwards.
+template <typename P, typename X, typename Y>
+constexpr P multiply_as(X x, Y y)
+{
+    if constexpr (std::is_integral_v<P>) {
+        using U = std::common_type_t<std::make_unsigned_t<P>, unsigned>;
+        return static_cast<P>(static_cast<U>(static_cast<P>(x)) *
+                              static_cast<U>(static_cast<P>(y)));
+    } else {
+        return static_cast<P>(static_cast<P>(x) * static_cast<P>(y));
+    }
+}
+
+template <typename Op, typename A, typename X, typename = void>
+inline constexpr bool has_compound_assign_v = false;
+
+template <typename Op, typename A, typename X>
+inline constexpr bool has_compound_assign_v<Op, A, X,
+    std::void_t<decltype(compound_assign<Op>::apply(std::declval<A&>(),
+                                                    std::declval<X>()))>> =
+    !std::is_scalar_v<A>;
+
+// acc = op(std::move(acc), x), in place where compound_assign allows
+template <typename Op, typename A, typename X>
+constexpr void accumulate_into(Op& op, A& acc, X&& x)
+{
+    if constexpr (has_compound_assign_v<Op, A, X>) {
+        compound_assign<Op>::apply(acc, std::forward<X>(x));
+    } else {
+        acc = _std::invoke(op, std::move(acc), std::forward<X>(x));
+    }
+}
+
+template <typename O>
+inline constexpr bool is_back_insert_iterator_v = false;
+
+template <typename C>
+inline constexpr bool is_back_insert_iterator_v<std::back_insert_iterator<C>> = true;
+
+// The container a back_insert_iterator appends to
+template <typename C>
+C& back_insert_container(const std::back_insert_iterator<C>& it)
+{
+    // It is a protected member, which a derived class can name
+    struct access : std::back_insert_iterator<C> {
+        static C& get(const std::back_insert_iterator<C>& i)
+        {
+            return *(i.*&access::container);
+        }
+    };
+    return access::get(it);
+}
+
+template <typename C, typename = void>
+inline constexpr bool has_reserve_v = false;
+
+template <typename C>
+inline constexpr bool has_reserve_v<C, std::void_t<
+    decltype(std::declval<C&>().reserve(std::size_t{})),
+    decltype(std::size_t{std::declval<const C&>().capacity()}),
+    decltype(std::size_t{std::declval<const C&>().size()})>> = true;
+
+// True for containers such as std::vector of arithmetic values, which can
+// be grown by n elements cheaply and then written through a pointer
+template <typename C, typename = void>
+inline constexpr bool is_resizable_contiguous_v = false;
+
+template <typename C>
+inline constexpr bool is_resizable_contiguous_v<C, std::void_t<
+    decltype(std::declval<C&>().resize(std::size_t{})),
+    decltype(std::declval<C&>().data())>> =
+    std::is_arithmetic_v<typename C::value_type> &&
+    std::is_same_v<decltype(std::declval<C&>().data()), typename C::value_type*>;
+
+// Makes room in c for n more elements, if it supports reserve(). The
+// capacity grows at least geometrically, so that repeatedly appending a
+// few elements does not reallocate every time.
+template <typename C>
+constexpr void reserve_more(C& c, std::size_t n)
+{
+    if constexpr (has_reserve_v<C>) {
+        const std::size_t want = c.size() + n;
+        if (want > c.capacity()) {
+            c.reserve(want > 2 * c.capacity() ? want : 2 * c.capacity());
+        }
+    }
+}
+
+// True if out, the destination of an n-element transform of in, is in
+// itself or does not overlap it at all
+template <typename E>
+bool same_or_disjoint(const E* in, const E* out, std::ptrdiff_t n)
+{
+    const std::less<const E*> less;
+    return in == out || !less(out, in + n) || !less(in, out + n);
+}
+
+} // detail
+
+}}
+
+#endif
@@ -0,0 +1,761 @@
+// numeric_ranges/delta_coding.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_DELTA_CODING_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_DELTA_CODING_HPP_INCLUDED
+
+#include "accumulate.hpp"
+#include "core.hpp"
+#include "dispatch.hpp"
+#include "partial_sum.hpp"
+
+#ifndef TCB_NUMERIC_RANGES_USE_NANORANGE
+#include <algorithm>
+#endif
+
+#include <array>
+#include <optional>
+
+namespace tcb {
+inline namespace ranges {
+
+// Delta coding of 32- and 64-bit integers, for compact storage of columns
+// such as sorted timestamps or IDs, where consecutive values are close.
+//
+// The encoded form is a sequence of words of type delta_word_t<T>: the
+// element count (one 64-bit value, low word first), then one block per 128
+// elements. Each element is replaced by the zigzag-coded difference from
+// its predecessor (so small negative differences stay small), and each
+// block stores the smallest of its 128 codes (its frame of reference) and
+// a bit width b, followed by each code minus that minimum packed into b
+// bits. The packing is interleaved across 128 bits' worth of lanes, so
+// that packing and unpacking proceed one vector register at a time. The
+// final block is padded to 128 elements.
+
+template <typename T>
+using delta_word_t = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+template <typename I, typename O>
+using delta_encode_result = rng::copy_result<I, O>;
+
+template <typename I, typename O>
+using delta_decode_result = rng::copy_result<I, O>;
+
+namespace detail {
+
+template <typename T>
+inline constexpr bool is_delta_codable_v =
+    std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+    (sizeof(T) == 4 || sizeof(T) == 8);
+
+inline constexpr std::ptrdiff_t delta_block_size = 128;
+
+template <typename W>
+struct delta_format {
+    static constexpr int bits = sizeof(W) * 8;
+    // Values are interleaved across this many lanes, one 128-bit register
+    static constexpr std::ptrdiff_t lanes = 128 / bits;
+    // Words holding the 64-bit element count at the start of the stream
+    static constexpr std::ptrdiff_t count_words = 64 / bits;
+    // Words of base and bit width at the start of each block
+    static constexpr std::ptrdiff_t block_header_words = 2;
+};
+
+template <typename W>
+constexpr W zigzag_encode(W delta) noexcept
+{
+    using S = std::make_signed_t<W>;
+    return static_cast<W>(delta << 1) ^
+           static_cast<W>(static_cast<S>(delta) >> (delta_format<W>::bits - 1));
+}
+
+template <typename W>
+constexpr W zigzag_decode(W code) noexcept
+{
+    return static_cast<W>((code >> 1) ^ (W(0) - (code & 1)));
+}
+
+// The number of bits needed to represent v
+template <typename W>
+constexpr int bit_width(W v) noexcept
+{
+    int b = 0;
+    while (v != 0) {
+        v >>= 1;
+        ++b;
+    }
+    return b;
+}
+
+// Packs the 128 values at v, each less than 2^b, into b * lanes words at
+// out. Lane j of the output words holds values j, j + lanes, ... in turn,
+// from the least significant bit up.
+template <typename W>
+constexpr void pack_block(const W* v, int b, W* out) noexcept
+{
+    constexpr int bits = delta_format<W>::bits;
+    constexpr std::ptrdiff_t L = delta_format<W>::lanes;
+    constexpr std::ptrdiff_t V = delta_block_size / L;
+
+    if (b == 0) {
+        return;
+    }
+
+    W acc[L] = {};
+    int shift = 0;
+    for (std::ptrdiff_t k = 0; k < V; ++k) {
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            acc[j] |= static_cast<W>(v[k * L + j] << shift);
+        }
+        shift += b;
+        if (shift >= bits) {
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                out[j] = acc[j];
+            }
+            out += L;
+            shift -= bits;
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                acc[j] = shift > 0 ? static_cast<W>(v[k * L + j] >> (b - shift)) : W(0);
+            }
+        }
+    }
+}
+
+// The inverse of pack_block: unpacks 128 values of b bits from the
+// b * lanes words at in
+template <typename W>
+constexpr void unpack_block(const W* in, int b, W* v) noexcept
+{
+    constexpr int bits = delta_format<W>::bits;
+    constexpr std::ptrdiff_t L = delta_format<W>::lanes;
+    constexpr std::ptrdiff_t V = delta_block_size / L;
+
+    if (b == 0) {
+        for (std::ptrdiff_t i = 0; i < delta_block_size; ++i) {
+            v[i] = 0;
+        }
+        return;
+    }
+
+    const W mask = b == bits ? static_cast<W>(~W(0)) : static_cast<W>((W(1) << b) - 1);
+    int shift = 0;
+    for (std::ptrdiff_t k = 0; k < V; ++k) {
+        if (shift + b <= bits) {
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                v[k * L + j] = static_cast<W>(in[j] >> shift) & mask;
+            }
+            shift += b;
+            if (shift == bits) {
+                in += L;
+                shift = 0;
+            }
+        } else {
+            const int low = bits - shift;
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                v[k * L + j] = static_cast<W>((in[j] >> shift) | (in[L + j] << low)) & mask;
+            }
+            in += L;
+            shift = b - low;
+        }
+    }
+}
+
+// pack_block and unpack_block for a fixed bit width B: every shift and word
+// offset is then a constant, so each step is a few vector shifts and ors
+template <typename W, int B, std::size_t K>
+TCB_NUMERIC_RANGES_ALWAYS_INLINE
+constexpr void pack_step(const W* v, W* out) noexcept
+{
+    constexpr int bits = delta_format<W>::bits;
+    constexpr std::ptrdiff_t L = delta_format<W>::lanes;
+    constexpr std::size_t first_bit = K * B;
+    constexpr std::ptrdiff_t word = static_cast<std::ptrdiff_t>(first_bit / bits);
+    constexpr int shift = static_cast<int>(first_bit % bits);
+
+    W x[L];
+    for (std::ptrdiff_t j = 0; j < L; ++j) {
+        x[j] = v[K * L + j];
+    }
+    for (std::ptrdiff_t j = 0; j < L; ++j) {
+        if constexpr (shift == 0) {
+            out[word * L + j] = x[j];
+        } else {
+            out[word * L + j] |= static_cast<W>(x[j] << shift);
+        }
+    }
+    if constexpr (shift + B > bits) {
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            out[(word + 1) * L + j] = static_cast<W>(x[j] >> (bits - shift));
+        }
+    }
+}
+
+template <typename W, int B, std::size_t K>
+TCB_NUMERIC_RANGES_ALWAYS_INLINE
+constexpr void unpack_step(const W* in, W* v) noexcept
+{
+    constexpr int bits = delta_format<W>::bits;
+    constexpr std::ptrdiff_t L = delta_format<W>::lanes;
+    constexpr std::size_t first_bit = K * B;
+    constexpr std::ptrdiff_t word = static_cast<std::ptrdiff_t>(first_bit / bits);
+    constexpr int shift = static_cast<int>(first_bit % bits);
+    constexpr W mask = B == bits ? static_cast<W>(~W(0)) : static_cast<W>((W(1) << B) - 1);
+
+    // All loads come before the stores, so that the compiler can keep the
+    // lanes in one register without proving that v and in do not overlap
+    W x[L];
+    for (std::ptrdiff_t j = 0; j < L; ++j) {
+        x[j] = static_cast<W>(in[word * L + j] >> shift);
+    }
+    if constexpr (shift + B > bits) {
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            x[j] |= static_cast<W>(in[(word + 1) * L + j] << (bits - shift));
+        }
+    }
+    for (std::ptrdiff_t j = 0; j < L; ++j) {
+        v[K * L + j] = x[j] & mask;
+    }
+}
+
+template <typename W, int B, std::size_t... K>
+constexpr void pack_fixed(const W* v, W* out, std::index_sequence<K...>) noexcept
+{
+    (pack_step<W, B, K>(v, out), ...);
+}
+
+template <typename W, int B, std::size_t... K>
+constexpr void unpack_fixed(const W* in, W* v, std::index_sequence<K...>) noexcept
+{
+    (unpack_step<W, B, K>(in, v), ...);
+}
+
+template <typename W>
+using delta_steps = std::make_index_sequence<delta_block_size / delta_format<W>::lanes>;
+
+template <typename W, int B>
+void pack_block_fixed(const W* v, W* out) noexcept
+{
+    pack_fixed<W, B>(v, out, delta_steps<W>{});
+}
+
+template <typename W, int B>
+void unpack_block_fixed(const W* in, W* v) noexcept
+{
+    if constexpr (B == 0) {
+        for (std::ptrdiff_t i = 0; i < delta_block_size; ++i) {
+            v[i] = 0;
+        }
+    } else {
+        unpack_fixed<W, B>(in, v, delta_steps<W>{});
+    }
+}
+
+// Tables of the fixed-width functions, indexed by bit width
+template <typename W, std::size_t... B>
+constexpr auto make_pack_table(std::index_sequence<B...>) noexcept
+{
+    using fn = void (*)(const W*, W*) noexcept;
+    return std::array<fn, sizeof...(B)>{{&pack_block_fixed<W, static_cast<int>(B)>...}};
+}
+
+template <typename W, std::size_t... B>
+constexpr auto make_unpack_table(std::index_sequence<B...>) noexcept
+{
+    using fn = void (*)(const W*, W*) noexcept;
+    return std::array<fn, sizeof...(B)>{{&unpack_block_fixed<W, static_cast<int>(B)>...}};
+}
+
+template <typename W>
+inline constexpr auto pack_table =
+    make_pack_table<W>(std::make_index_sequence<delta_format<W>::bits + 1>{});
+
+template <typename W>
+inline constexpr auto unpack_table =
+    make_unpack_table<W>(std::make_index_sequence<delta_format<W>::bits + 1>{});
+
+// Codes the m <= 128 values at x, continuing from prev, into one block's
+// header and packed words at out. Returns the number of words written.
+template <typename W>
+constexpr std::ptrdiff_t encode_block(const W* x, std::ptrdiff_t m, W& prev, W* out) noexcept
+{
+    W z[delta_block_size] = {};
+    W base = static_cast<W>(~W(0));
+    for (std::ptrdiff_t i = 0; i < m; ++i) {
+        z[i] = zigzag_encode(static_cast<W>(x[i] - prev));
+        prev = x[i];
+        base = z[i] < base ? z[i] : base;
+    }
+    for (std::ptrdiff_t i = m; i < delta_block_size; ++i) {
+        z[i] = base;
+    }
+
+    W bits_used = 0;
+    for (std::ptrdiff_t i = 0; i < delta_block_size; ++i) {
+        z[i] = static_cast<W>(z[i] - base);
+        bits_used |= z[i];
+    }
+    const int b = bit_width(bits_used);
+
+    out[0] = base;
+    out[1] = static_cast<W>(b);
+    if (detail::is_constant_evaluated()) {
+        pack_block(z, b, out + delta_format<W>::block_header_words);
+    } else if (b > 0) {
+        pack_table<W>[static_cast<std::size_t>(b)](z, out + delta_format<W>::block_header_words);
+    }
+    return delta_format<W>::block_header_words + b * delta_format<W>::lanes;
+}
+
+// Decodes one block, whose packed words start at packed, into 128 values
+// of type T at out, continuing the running sum from prev. The codes are
+// first unpacked into codes, which may be out itself when T is W.
+template <typename W, typename T>
+constexpr void decode_block(const W* packed, W base, int b, W prev, W* codes, T* out) noexcept
+{
+    if (detail::is_constant_evaluated()) {
+        unpack_block(packed, b, codes);
+    } else {
+        unpack_table<W>[static_cast<std::size_t>(b)](packed, codes);
+    }
+    // Undo the frame of reference and zigzag coding in one vectorisable
+    // pass, leaving only the additions in the serial running sum
+    for (std::ptrdiff_t i = 0; i < delta_block_size; ++i) {
+        out[i] = static_cast<T>(zigzag_decode(static_cast<W>(codes[i] + base)));
+    }
+    if (detail::is_constant_evaluated()) {
+        for (std::ptrdiff_t i = 0; i < delta_block_size; ++i) {
+            prev = static_cast<W>(prev + static_cast<W>(out[i]));
+            out[i] = static_cast<T>(prev);
+        }
+    } else {
+        dispatch<partial_sum_kernel>(static_cast<const T*>(out), out, delta_block_size,
+                                     static_cast<T>(prev));
+    }
+}
+
+// Reads the blocks of a delta-coded sequence of words in turn
+template <typename I, typename S>
+class delta_block_reader {
+    using W = std::remove_cv_t<_std::iter_value_t<I>>;
+    using F = delta_format<W>;
+
+public:
+    using word_type = W;
+
+    constexpr delta_block_reader(I first, S last)
+        : first_(std::move(first)), last_(std::move(last))
+    {
+        W words[F::count_words] = {};
+        if (const W* p = next_words(words, F::count_words)) {
+            for (std::ptrdiff_t k = 0; k < F::count_words; ++k) {
+                remaining_ |= static_cast<std::uint64_t>(p[k]) << (k * F::bits);
+            }
+        }
+    }
+
+    // The number of values not yet decoded
+    constexpr std::uint64_t remaining() const { return remaining_; }
+
+    // Decodes the next block into out, which must have room for 128
+    // values of W or of the signed integer of the same size, and returns
+    // how many of them are part of the sequence: 0 at the end, or if the
+    // input is truncated or malformed
+    template <typename T>
+    constexpr std::ptrdiff_t next(T* out)
+    {
+        if (remaining_ == 0) {
+            return 0;
+        }
+
+        W header[F::block_header_words] = {};
+        const W* h = next_words(header, F::block_header_words);
+        if (h == nullptr || h[1] > static_cast<W>(F::bits)) {
+            remaining_ = 0;
+            return 0;
+        }
+        const W base = h[0];
+        const int b = static_cast<int>(h[1]);
+
+        const W* packed = next_words(packed_, b * F::lanes);
+        if (packed == nullptr) {
+            remaining_ = 0;
+            return 0;
+        }
+
+        if constexpr (std::is_same_v<T, W>) {
+            decode_block(packed, base, b, prev_, out, out);
+        } else {
+            decode_block(packed, base, b, prev_, codes_, out);
+        }
+        prev_ = static_cast<W>(out[delta_block_size - 1]);
+
+        const auto m = remaining_ < std::uint64_t(delta_block_size)
+                           ? static_cast<std::ptrdiff_t>(remaining_) : delta_block_size;
+        remaining_ -= static_cast<std::uint64_t>(m);
+        return m;
+    }
+
+    // The position in the input after the last block read
+    constexpr I position() && { return std::move(first_); }
+
+private:
+    // Returns a pointer to the next count words of input, which points
+    // into the input itself if it is contiguous and is otherwise a copy in
+    // buf, or nullptr if fewer than count words remain
+    constexpr const W* next_words(W* buf, std::ptrdiff_t count)
+    {
+        if constexpr (is_contiguous_sized_v<I, S>) {
+            if (last_ - first_ < count) {
+                first_ = rng::next(first_, last_);
+                return nullptr;
+            }
+            if (count == 0) {
+                return buf;
+            }
+            const W* p = std::addressof(*first_);
+            first_ += count;
+            return p;
+        } else {
+            for (std::ptrdiff_t k = 0; k < count; ++k, ++first_) {
+                if (first_ == last_) {
+                    return nullptr;
+                }
+                buf[k] = *first_;
+            }
+            return buf;
+        }
+    }
+
+    I first_;
+    S last_;
+    std::uint64_t remaining_ = 0;
+    W prev_ = 0;
+    W packed_[delta_block_size] = {};
+    // The unpacked codes of a block being decoded into values other than W
+    W codes_[delta_block_size] = {};
+};
+
+// The value type written by an output iterator which, like a pointer, has
+// one; otherwise W
+template <typename O, typename W, typename = void>
+struct delta_output_value {
+    using type = W;
+};
+
+template <typename O, typename W>
+struct delta_output_value<O, W, std::void_t<_std::iter_value_t<O>>> {
+    using type = _std::iter_value_t<O>;
+};
+
+struct delta_encode_fn {
+private:
+    template <typename I, typename S, typename O>
+    static constexpr delta_encode_result<I, O>
+    impl(I first, S last, std::uint64_t n, O out)
+    {
+        using W = delta_word_t<_std::iter_value_t<I>>;
+        using F = delta_format<W>;
+
+        for (std::ptrdiff_t k = 0; k < F::count_words; ++k) {
+            *out = static_cast<W>(n >> (k * F::bits));
+            ++out;
+        }
+
+        W x[delta_block_size] = {};
+        W words[F::block_header_words + delta_block_size] = {};
+        W prev = 0;
+        while (first != last) {
+            std::ptrdiff_t m = 0;
+            for (; m < delta_block_size && first != last; ++m, ++first) {
+                x[m] = static_cast<W>(*first);
+            }
+            const auto count = encode_block(x, m, prev, words);
+            for (std::ptrdiff_t k = 0; k < count; ++k) {
+                *out = words[k];
+                ++out;
+            }
+        }
+
+        return {std::move(first), std::move(out)};
+    }
+
+public:
+    template <typename I, typename S, typename O>
+    constexpr auto operator()(I first, S last, O out) const
+    -> std::enable_if_t<
+        _std::input_iterator<I> && _std::sized_sentinel_for<S, I> &&
+            is_delta_codable_v<_std::iter_value_t<I>>,
+        delta_encode_result<I, O>>
+    {
+        const auto n = static_cast<std::uint64_t>(last - first);
+        return impl(std::move(first), std::move(last), n, std::move(out));
+    }
+
+    template <typename R, typename O>
+    constexpr auto operator()(R&& r, O out) const
+    -> std::enable_if_t<
+        rng::input_range<R> && rng::sized_range<R> &&
+            is_delta_codable_v<rng::range_value_t<R>>,
+        delta_encode_result<rng::borrowed_iterator_t<R>, O>>
+    {
+        const auto n = static_cast<std::uint64_t>(rng::size(r));
+        return impl(rng::begin(r), rng::end(r), n, std::move(out));
+    }
+};
+
+struct delta_decode_fn {
+private:
+    template <typename I, typename S, typename O>
+    static constexpr delta_decode_result<I, O> impl(I first, S last, O out)
+    {
+        using reader_t = delta_block_reader<I, S>;
+        using W = typename reader_t::word_type;
+        using V = typename delta_output_value<O, W>::type;
+
+        reader_t reader(std::move(first), std::move(last));
+        W values[delta_block_size] = {};
+        while (const auto m = reader.next(values)) {
+            for (std::ptrdiff_t i = 0; i < m; ++i) {
+                *out = static_cast<V>(values[i]);
+                ++out;
+            }
+        }
+
+        return {std::move(reader).position(), std::move(out)};
+    }
+
+public:
+    template <typename I, typename S, typename O>
+    constexpr auto operator()(I first, S last, O out) const
+    -> std::enable_if_t<
+        _std::input_iterator<I> && _std::sentinel_for<S, I> &&
+            is_delta_codable_v<_std::iter_value_t<I>> &&
+            std::is_unsigned_v<_std::iter_value_t<I>>,
+        delta_decode_result<I, O>>
+    {
+        return impl(std::move(first), std::move(last), std::move(out));
+    }
+
+    template <typename R, typename O>
+    constexpr auto operator()(R&& r, O out) const
+    -> std::enable_if_t<
+        rng::input_range<R> &&
+            is_delta_codable_v<rng::range_value_t<R>> &&
+            std::is_unsigned_v<rng::range_value_t<R>>,
+        delta_decode_result<rng::borrowed_iterator_t<R>, O>>
+    {
+        return impl(rng::begin(r), rng::end(r), std::move(out));
+    }
+};
+
+template <typename W, typename T>
+inline constexpr bool is_delta_word_for_v =
+    std::is_unsigned_v<W> && is_delta_codable_v<W> && is_delta_codable_v<T> &&
+    sizeof(W) == sizeof(T);
+
+template <typename T>
+struct reduce_delta_coded_fn {
+    static_assert(is_delta_codable_v<T>,
+                  "reduce_delta_coded<T> requires a 32- or 64-bit integer type");
+
+    // Decodes one block at a time, as values of T, into a buffer which stays
+    // in L1, and reduces the block's values while they are there, so the
+    // decoded values are never written out in full. With the default
+    // operation, each block is reduced by the vectorised reduce kernel.
+    template <typename I, typename S, typename Init = T, typename Op = std::plus<>>
+    constexpr auto operator()(I first, S last, Init init = Init{}, Op op = Op{}) const
+    -> std::enable_if_t<
+        _std::input_iterator<I> && _std::sentinel_for<S, I> &&
+            is_delta_word_for_v<_std::iter_value_t<I>, T>,
+        Init>
+    {
+        using reader_t = delta_block_reader<I, S>;
+
+        reader_t reader(std::move(first), std::move(last));
+        T values[delta_block_size] = {};
+        while (const auto m = reader.next(values)) {
+            init = reduce_fn{}(values + 0, values + m, std::move(init), op);
+        }
+        return init;
+    }
+
+    template <typename R, typename Init = T, typename Op = std::plus<>>
+    constexpr auto operator()(R&& r, Init init = Init{}, Op op = Op{}) const
+    -> std::enable_if_t<
+        rng::input_range<R> && is_delta_word_for_v<rng::range_value_t<R>, T>,
+        Init>
+    {
+        return (*this)(rng::begin(r), rng::end(r), std::move(init), std::move(op));
+    }
+};
+
+} // namespace detail
+
+// A single-pass view of the values of type T decoded from the words of a
+// delta-coded range, as written by delta_encode. Blocks are decoded as
+// iteration reaches them, so at most 128 values are held at a time. As
+// with std::ranges::istream_view, begin() may only be called once.
+template <typename T, typename V>
+class delta_decoded_view : public rng::view_interface<delta_decoded_view<T, V>> {
+    using reader_t = detail::delta_block_reader<rng::iterator_t<V>, rng::sentinel_t<V>>;
+    using W = typename reader_t::word_type;
+
+public:
+    struct sentinel {};
+
+    class iterator {
+        friend class delta_decoded_view;
+
+        delta_decoded_view* parent_ = nullptr;
+
+        constexpr explicit iterator(delta_decoded_view* parent) : parent_(parent) {}
+
+        constexpr bool at_end() const { return parent_->pos_ == parent_->size_; }
+
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        constexpr T operator*() const
+        {
+            return static_cast<T>(parent_->values_[parent_->pos_]);
+        }
+
+        constexpr iterator& operator++()
+        {
+            if (++parent_->pos_ == parent_->size_) {
+                parent_->next_block();
+            }
+            return *this;
+        }
+
+        constexpr void operator++(int) { ++*this; }
+
+        friend constexpr bool operator==(const iterator& i, const sentinel&)
+        {
+            return i.at_end();
+        }
+
+        friend constexpr bool operator==(const sentinel& s, const iterator& i)
+        {
+            return i == s;
+        }
+
+        friend constexpr bool operator!=(const iterator& i, const sentinel& s)
+        {
+            return !(i == s);
+        }
+
+        friend constexpr bool operator!=(const sentinel& s, const iterator& i)
+        {
+            return !(i == s);
+        }
+    };
+
+    delta_decoded_view() = default;
+
+    constexpr explicit delta_decoded_view(V base) : base_(std::move(base)) {}
+
+    constexpr V base() const { return base_; }
+
+    constexpr iterator begin()
+    {
+        reader_.emplace(rng::begin(base_), rng::end(base_));
+        next_block();
+        return iterator{this};
+    }
+
+    constexpr sentinel end() const { return {}; }
+
+private:
+    constexpr void next_block()
+    {
+        pos_ = 0;
+        size_ = reader_->next(values_);
+    }
+
+    V base_ = V();
+    std::optional<reader_t> reader_;
+    W values_[detail::delta_block_size] = {};
+    std::ptrdiff_t pos_ = 0;
+    std::ptrdiff_t size_ = 0;
+};
+
+namespace detail {
+
+template <typename T>
+struct delta_decoded_closure {
+    template <typename R>
+    friend constexpr auto operator|(R&& r, delta_decoded_closure)
+    -> std::enable_if_t<
+        rng::viewable_range<R> && rng::input_range<R> &&
+            is_delta_word_for_v<rng::range_value_t<R>, T>,
+        delta_decoded_view<T, decltype(rng::views::all(std::declval<R>()))>>
+    {
+        return delta_decoded_view<T, decltype(rng::views::all(std::declval<R>()))>(
+            rng::views::all(std::forward<R>(r)));
+    }
+};
+
+template <typename T>
+struct delta_decoded_view_fn : delta_decoded_closure<T> {
+    static_assert(is_delta_codable_v<T>,
+                  "delta_decoded<T> requires a 32- or 64-bit integer type");
+
+    template <typename R>
+    constexpr auto operator()(R&& r) const
+    -> std::enable_if_t<
+        rng::viewable_range<R> && rng::input_range<R> &&
+            is_delta_word_for_v<rng::range_value_t<R>, T>,
+        delta_decoded_view<T, decltype(rng::views::all(std::declval<R>()))>>
+    {
+        return std::forward<R>(r) | delta_decoded_closure<T>{};
+    }
+};
+
+} // namespace detail
+
+// The largest number of words delta_encode can write for n values of T
+template <typename T>
+constexpr std::size_t delta_encode_bound(std::size_t n) noexcept
+{
+    using F = detail::delta_format<delta_word_t<T>>;
+    const auto blocks = (n + detail::delta_block_size - 1) / detail::delta_block_size;
+    return F::count_words + blocks * (F::block_header_words + detail::delta_block_size);
+}
+
+// delta_encode(first, last, out) / delta_encode(r, out) writes the encoded
+// form of a sized range of 32- or 64-bit integers to out, as words of type
+// delta_word_t<T>
+inline constexpr auto delta_encode = detail::delta_encode_fn{};
+
+// delta_decode(first, last, out) / delta_decode(r, out) decodes the words
+// written by delta_encode, writing the values to out. Decoding stops early
+// if the input is truncated or malformed.
+inline constexpr auto delta_decode = detail::delta_decode_fn{};
+
+// reduce_delta_coded<T>(first, last, init, op) / reduce_delta_coded<T>(r,
+// init, op) is reduce(decoded, init, op) over the values of type T encoded
+// in the words [first, last), without materialising the decoded values
+template <typename T>
+inline constexpr auto reduce_delta_coded = detail::reduce_delta_coded_fn<T>{};
+
+namespace views {
+
+// views::delta_decoded<T>(r), or r | views::delta_decoded<T>, lazily decodes
+// the values of type T encoded in the words of r
+template <typename T>
+inline constexpr auto delta_decoded = detail::delta_decoded_view_fn<T>{};
+
+}
+
+}}
+
+#endif
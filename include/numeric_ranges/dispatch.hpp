@@ -0,0 +1,175 @@
+// numeric_ranges/dispatch.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_DISPATCH_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_DISPATCH_HPP_INCLUDED
+
+#include "core.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+
+// With GCC and Clang on x86, the SIMD kernels are compiled for several
+// instruction sets and the best one the CPU supports is chosen at run time.
+// Define TCB_NUMERIC_RANGES_NO_DISPATCH to compile only for the target
+// selected on the command line.
+#if !defined(TCB_NUMERIC_RANGES_NO_DISPATCH) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define TCB_NUMERIC_RANGES_DISPATCH 1
+#define TCB_NUMERIC_RANGES_ALWAYS_INLINE __attribute__((always_inline)) inline
+#define TCB_NUMERIC_RANGES_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define TCB_NUMERIC_RANGES_TARGET_AVX512 \
+    __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx2,fma")))
+#else
+#define TCB_NUMERIC_RANGES_ALWAYS_INLINE inline
+#endif
+
+namespace tcb {
+inline namespace ranges {
+
+// Instruction set tiers for which the SIMD kernels behind accumulate,
+// reduce, inner_product, transform_reduce, adjacent_difference, partial_sum
+// and iota are compiled. Each tier adds its instructions to those enabled
+// for the translation unit, so `scalar` means "the command-line target".
+enum class simd_isa { scalar, avx2, avx512 };
+
+namespace detail {
+
+inline simd_isa detect_simd_isa() noexcept
+{
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) {
+        return simd_isa::avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return simd_isa::avx2;
+    }
+#endif
+    return simd_isa::scalar;
+}
+
+inline simd_isa cached_simd_isa() noexcept
+{
+    static const simd_isa isa = detect_simd_isa();
+    return isa;
+}
+
+// Parses a tier name as accepted by the TCB_NUMERIC_RANGES_ISA environment
+// variable
+inline std::optional<simd_isa> parse_simd_isa(const char* name) noexcept
+{
+    if (name == nullptr) {
+        return std::nullopt;
+    }
+    if (std::strcmp(name, "scalar") == 0) {
+        return simd_isa::scalar;
+    }
+    if (std::strcmp(name, "avx2") == 0) {
+        return simd_isa::avx2;
+    }
+    if (std::strcmp(name, "avx512") == 0) {
+        return simd_isa::avx512;
+    }
+    return std::nullopt;
+}
+
+inline simd_isa supported_simd_isa(simd_isa isa) noexcept
+{
+    const simd_isa best = cached_simd_isa();
+    return isa < best ? isa : best;
+}
+
+inline simd_isa initial_simd_isa() noexcept
+{
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+    if (const auto requested = parse_simd_isa(std::getenv("TCB_NUMERIC_RANGES_ISA"))) {
+        return supported_simd_isa(*requested);
+    }
+#endif
+    return cached_simd_isa();
+}
+
+inline std::atomic<simd_isa>& active_simd_isa_storage() noexcept
+{
+    static std::atomic<simd_isa> isa{initial_simd_isa()};
+    return isa;
+}
+
+} // namespace detail
+
+// The best tier supported by this CPU, detected once via cpuid
+inline simd_isa detected_simd_isa() noexcept
+{
+    return detail::cached_simd_isa();
+}
+
+// The tier the kernels currently run. Initially detected_simd_isa(), or the
+// tier named by the TCB_NUMERIC_RANGES_ISA environment variable ("scalar",
+// "avx2" or "avx512") if the CPU supports it.
+inline simd_isa active_simd_isa() noexcept
+{
+    return detail::active_simd_isa_storage().load(std::memory_order_relaxed);
+}
+
+// Selects the tier used by subsequent calls, lowered to detected_simd_isa()
+// if the CPU cannot run it, and returns the tier actually selected
+inline simd_isa set_simd_isa(simd_isa isa) noexcept
+{
+    isa = detail::supported_simd_isa(isa);
+    detail::active_simd_isa_storage().store(isa, std::memory_order_relaxed);
+    return isa;
+}
+
+namespace detail {
+
+// Instantiates Kernel::run once per simd_isa tier, each wrapper compiled for
+// that tier's instruction set. Kernel::run is TCB_NUMERIC_RANGES_ALWAYS_INLINE
+// so that its body is vectorised afresh inside every wrapper.
+template <typename Kernel, typename R, typename... Args>
+struct kernel_clones {
+    static R scalar(Args... args)
+    {
+        return Kernel::template run<simd_isa::scalar>(args...);
+    }
+
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+    TCB_NUMERIC_RANGES_TARGET_AVX2
+    static R avx2(Args... args)
+    {
+        return Kernel::template run<simd_isa::avx2>(args...);
+    }
+
+    TCB_NUMERIC_RANGES_TARGET_AVX512
+    static R avx512(Args... args)
+    {
+        return Kernel::template run<simd_isa::avx512>(args...);
+    }
+
+    static constexpr R (*table[])(Args...) = {&scalar, &avx2, &avx512};
+#else
+    static constexpr R (*table[])(Args...) = {&scalar};
+#endif
+};
+
+// Calls the clone of Kernel::run for the active tier
+template <typename Kernel, typename... Args>
+auto dispatch(Args... args)
+    -> decltype(Kernel::template run<simd_isa::scalar>(args...))
+{
+    using R = decltype(Kernel::template run<simd_isa::scalar>(args...));
+    const auto isa = static_cast<std::size_t>(active_simd_isa());
+    return kernel_clones<Kernel, R, Args...>::table[isa](args...);
+}
+
+} // detail
+
+}}
+
+#endif
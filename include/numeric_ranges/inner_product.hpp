@@ -0,0 +1,401 @@
+// numeric_ranges/inner_product.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_INNER_PRODUCT_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_INNER_PRODUCT_HPP_INCLUDED
+
+#include "accumulate.hpp"
+#include "core.hpp"
+#include "dispatch.hpp"
+#include "segmented.hpp"
+#include "strided_span.hpp"
+
+#include <limits>
+
+namespace tcb {
+inline namespace ranges {
+
+namespace detail {
+
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+// Dot product of floats in double lanes, converting in-register as
+// widened_sum_avx2 does. Each product is formed in P, as op2 forms it: in
+// double (as by std::multiplies<double>) the product of two floats is exact,
+// so fusing the multiply and add does not change it; in float (as by
+// std::multiplies<>) it is rounded to float before it is widened. (32-bit
+// integers into 64-bit lanes are left to dot_kernel's loop, which measured
+// as fast as vpmovsxdq and vpmuldq.)
+template <typename P>
+TCB_NUMERIC_RANGES_TARGET_AVX2
+inline double widened_dot_avx2(const float* a, const float* b, std::ptrdiff_t n)
+{
+    __m256d acc0{}, acc1{}, acc2{}, acc3{};
+    std::ptrdiff_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        if constexpr (std::is_same_v<P, double>) {
+            acc0 = _mm256_fmadd_pd(widen4_avx2(a + i), widen4_avx2(b + i), acc0);
+            acc1 = _mm256_fmadd_pd(widen4_avx2(a + i + 4), widen4_avx2(b + i + 4), acc1);
+            acc2 = _mm256_fmadd_pd(widen4_avx2(a + i + 8), widen4_avx2(b + i + 8), acc2);
+            acc3 = _mm256_fmadd_pd(widen4_avx2(a + i + 12), widen4_avx2(b + i + 12), acc3);
+        } else {
+            const __m256 p0 = _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+            const __m256 p1 = _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+            acc0 = _mm256_add_pd(acc0, _mm256_cvtps_pd(_mm256_castps256_ps128(p0)));
+            acc1 = _mm256_add_pd(acc1, _mm256_cvtps_pd(_mm256_extractf128_ps(p0, 1)));
+            acc2 = _mm256_add_pd(acc2, _mm256_cvtps_pd(_mm256_castps256_ps128(p1)));
+            acc3 = _mm256_add_pd(acc3, _mm256_cvtps_pd(_mm256_extractf128_ps(p1, 1)));
+        }
+    }
+
+    double sum = horizontal_sum_avx2<double>(add4_avx2(add4_avx2(acc0, acc1), add4_avx2(acc2, acc3)));
+    for (; i < n; ++i) {
+        sum += double(P(a[i]) * P(b[i]));
+    }
+    return sum;
+}
+#endif
+
+// Exact dot product of 8- or 16-bit integers, modulo 2^64. Products of
+// bytes are at most 2^16 in magnitude, so a 32-bit lane can absorb 2^15 of
+// them before it must be flushed into the 64-bit total; the lane updates
+// are the shape that compilers lower to widening multiply-adds. Products
+// involving 16-bit values need 64-bit lanes.
+struct widening_dot_kernel {
+    template <simd_isa, typename A, typename B>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static std::uint64_t run(const A* a, const B* b, std::ptrdiff_t n)
+    {
+        constexpr bool bytes = sizeof(A) == 1 && sizeof(B) == 1;
+        using lane_t = std::conditional_t<bytes, std::int32_t, std::uint64_t>;
+        constexpr std::ptrdiff_t L = kernel_lanes<lane_t>;
+        constexpr std::ptrdiff_t chunk =
+            bytes ? L * (std::ptrdiff_t(1) << 15) : (std::numeric_limits<std::ptrdiff_t>::max)();
+
+        std::uint64_t total = 0;
+        std::ptrdiff_t i = 0;
+
+        while (n - i >= L) {
+            const std::ptrdiff_t full = (n - i) / L * L;
+            const std::ptrdiff_t e = i + (full < chunk ? full : chunk);
+
+            lane_t acc[L] = {};
+            for (; i < e; i += L) {
+                for (std::ptrdiff_t j = 0; j < L; ++j) {
+                    acc[j] += static_cast<lane_t>(std::int64_t(a[i + j]) * std::int64_t(b[i + j]));
+                }
+            }
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                total += static_cast<std::uint64_t>(static_cast<std::int64_t>(acc[j]));
+            }
+        }
+
+        for (; i < n; ++i) {
+            total += static_cast<std::uint64_t>(std::int64_t(a[i]) * std::int64_t(b[i]));
+        }
+
+        return total;
+    }
+};
+
+// Dot product of n elements in kernel_lanes<A> independent accumulators of
+// type A. Each product is formed in P, the type op2 forms it in (see
+// multiply_as), and only then converted to A: the sum may be reassociated,
+// but the products are op2's. Floats summed in doubles use widened_dot_avx2
+// in the vector tiers.
+template <typename A, typename P>
+struct dot_kernel {
+    template <simd_isa Isa, typename E1, typename E2>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static A run(const E1* a, const E2* b, std::ptrdiff_t n)
+    {
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+        if constexpr (Isa != simd_isa::scalar && std::is_same_v<E1, float> &&
+                      std::is_same_v<E2, float> && std::is_same_v<A, double> &&
+                      (std::is_same_v<P, float> || std::is_same_v<P, double>)) {
+            return widened_dot_avx2<P>(a, b, n);
+        }
+#endif
+        constexpr std::ptrdiff_t L = kernel_lanes<A>;
+
+        A acc[L] = {};
+        std::ptrdiff_t i = 0;
+        for (; i + L <= n; i += L) {
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                acc[j] += static_cast<A>(multiply_as<P>(a[i + j], b[i + j]));
+            }
+        }
+
+        A sum = A{};
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            sum += acc[j];
+        }
+        for (; i < n; ++i) {
+            sum += static_cast<A>(multiply_as<P>(a[i], b[i]));
+        }
+        return sum;
+    }
+};
+
+// As dot_kernel, for two sequences of n elements, each a fixed stride apart
+template <typename A, typename P>
+struct strided_dot_kernel {
+    template <simd_isa, typename E1, typename E2>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static A run(strided_elements<E1> a, strided_elements<E2> b, std::ptrdiff_t n)
+    {
+        constexpr std::ptrdiff_t L = kernel_lanes<A>;
+
+        A acc[L] = {};
+        std::ptrdiff_t i = 0;
+        for (; i + L <= n; i += L) {
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                acc[j] += static_cast<A>(multiply_as<P>(a[i + j], b[i + j]));
+            }
+        }
+
+        A sum = A{};
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            sum += acc[j];
+        }
+        for (; i < n; ++i) {
+            sum += static_cast<A>(multiply_as<P>(a[i], b[i]));
+        }
+        return sum;
+    }
+};
+
+// inner_product, and (with Reassociate) transform_reduce, which may also
+// split floating-point sums across SIMD lanes
+template <bool Reassociate>
+struct basic_inner_product_fn {
+private:
+    template <typename I1, typename S1, typename I2, typename S2, typename T,
+        typename Op1, typename Op2, typename Proj1, typename Proj2>
+    static constexpr T impl(I1 first1, S1 last1, I2 first2, S2 last2, T init,
+                            Op1& op1, Op2& op2, Proj1& proj1, Proj2& proj2)
+    {
+        using E1 = _std::iter_value_t<I1>;
+        using E2 = _std::iter_value_t<I2>;
+
+        // Narrow integers accumulated into a wide integer
+        if constexpr (is_contiguous_sized_v<I1, S1> &&
+                      is_contiguous_sized_v<I2, S2> &&
+                      is_narrow_integer_v<E1> && is_narrow_integer_v<E2> &&
+                      is_wide_integer_v<T> &&
+                      is_std_op_v<std::plus, Op1, T> &&
+                      is_std_op_v<std::multiplies, Op2, T> &&
+                      std::is_same_v<Proj1, _std::identity> &&
+                      std::is_same_v<Proj2, _std::identity>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n1 = last1 - first1;
+                const auto n2 = last2 - first2;
+                const std::ptrdiff_t n = n1 < n2 ? n1 : n2;
+                if (n == 0) {
+                    return init;
+                }
+                const auto total = dispatch<widening_dot_kernel>(
+                    std::addressof(*first1), std::addressof(*first2), n);
+                // The total is modulo 2^64; a signed product may be negative,
+                // which matters when T is wider than that
+                if constexpr (sizeof(T) > sizeof(std::uint64_t) &&
+                              (std::is_signed_v<E1> || std::is_signed_v<E2>)) {
+                    return wrapping_add(init, static_cast<std::int64_t>(total));
+                } else {
+                    return wrapping_add(init, total);
+                }
+            }
+        } else if constexpr (is_contiguous_sized_v<I1, S1> &&
+                             is_contiguous_sized_v<I2, S2> &&
+                             is_lane_summable_v<Reassociate, E1, T> &&
+                             is_lane_summable_v<Reassociate, E2, T> &&
+                             is_std_op_v<std::plus, Op1, T> &&
+                             is_std_op_v<std::multiplies, Op2, T> &&
+                             std::is_same_v<Proj1, _std::identity> &&
+                             std::is_same_v<Proj2, _std::identity>) {
+            if (!detail::is_constant_evaluated()) {
+                using A = lane_accumulator_t<T>;
+                using P = product_t<Op2, E1, E2>;
+                const auto n1 = last1 - first1;
+                const auto n2 = last2 - first2;
+                const std::ptrdiff_t n = n1 < n2 ? n1 : n2;
+                if (n == 0) {
+                    return init;
+                }
+                return static_cast<T>(static_cast<A>(init) +
+                    dispatch<dot_kernel<A, P>>(std::addressof(*first1),
+                                            std::addressof(*first2), n));
+            }
+        } else if constexpr (is_strided_projection_v<I1, S1, Proj1> &&
+                             is_strided_projection_v<I2, S2, Proj2> &&
+                             is_lane_summable_v<Reassociate, strided_value_t<I1, Proj1>, T> &&
+                             is_lane_summable_v<Reassociate, strided_value_t<I2, Proj2>, T> &&
+                             is_std_op_v<std::plus, Op1, T> &&
+                             is_std_op_v<std::multiplies, Op2, T>) {
+            // A column of a matrix, say, or a field of an array of structs,
+            // with another or with a vector
+            if (!detail::is_constant_evaluated()) {
+                using A = lane_accumulator_t<T>;
+                using P = product_t<Op2, strided_value_t<I1, Proj1>, strided_value_t<I2, Proj2>>;
+                const auto n1 = last1 - first1;
+                const auto n2 = last2 - first2;
+                const std::ptrdiff_t n = n1 < n2 ? n1 : n2;
+                if (n == 0) {
+                    return init;
+                }
+                return static_cast<T>(static_cast<A>(init) +
+                    dispatch<strided_dot_kernel<A, P>>(strided_elements_of(first1, proj1),
+                                                       strided_elements_of(first2, proj2), n));
+            }
+        } else if constexpr (is_segmented_v<I1, S1> &&
+                             _std::random_access_iterator<I2> &&
+                             _std::sized_sentinel_for<S2, I2>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n2 = last2 - first2;
+                return zip_segments<true>([&](auto f) {
+                    for_each_segment(std::move(first1), std::move(last1), f);
+                }, std::move(first2), n2, std::move(init), op1, op2, proj1, proj2);
+            }
+        } else if constexpr (is_segmented_v<I2, S2> &&
+                             _std::random_access_iterator<I1> &&
+                             _std::sized_sentinel_for<S1, I1>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n1 = last1 - first1;
+                return zip_segments<false>([&](auto f) {
+                    for_each_segment(std::move(first2), std::move(last2), f);
+                }, std::move(first1), n1, std::move(init), op1, op2, proj1, proj2);
+            }
+        }
+
+        using R1 = std::invoke_result_t<Proj1&, _std::iter_reference_t<I1>>;
+        using R2 = std::invoke_result_t<Proj2&, _std::iter_reference_t<I2>>;
+        using P = std::remove_cv_t<std::remove_reference_t<R1>>;
+
+        if constexpr (has_compound_assign_v<Op2, P, R2> &&
+                      has_compound_assign_v<Op1, T, P&> &&
+                      std::is_constructible_v<P, R1> && std::is_assignable_v<P&, R1>) {
+            // Form each product in place in a scratch value, reusing its
+            // storage, rather than in a new temporary each time
+            if (first1 == last1 || first2 == last2) {
+                return init;
+            }
+            P prod(_std::invoke(proj1, *first1));
+            for (;;) {
+                compound_assign<Op2>::apply(prod, _std::invoke(proj2, *first2));
+                compound_assign<Op1>::apply(init, prod);
+                if (++first1 == last1 || ++first2 == last2) {
+                    return init;
+                }
+                prod = _std::invoke(proj1, *first1);
+            }
+        } else {
+            while (first1 != last1 && first2 != last2) {
+                accumulate_into(op1, init,
+                                _std::invoke(op2, _std::invoke(proj1, *first1),
+                                                  _std::invoke(proj2, *first2)));
+                ++first1;
+                ++first2;
+            }
+
+            return init;
+        }
+    }
+
+    // Pairs each segment visited by walk with the same number of elements
+    // of the other, random-access, sequence [other, other + n), which is the
+    // second sequence if SegmentsFirst and the first otherwise
+    template <bool SegmentsFirst, typename Walk, typename J, typename T,
+        typename Op1, typename Op2, typename Proj1, typename Proj2>
+    static T zip_segments(Walk walk, J other, _std::iter_difference_t<J> n, T init,
+                          Op1& op1, Op2& op2, Proj1& proj1, Proj2& proj2)
+    {
+        walk([&](auto* p, auto* q) {
+            auto m = static_cast<_std::iter_difference_t<J>>(q - p);
+            if (m > n) {
+                m = n;
+            }
+            if (m <= 0) {
+                return;
+            }
+            if constexpr (SegmentsFirst) {
+                init = impl(p, p + m, other, other + m, std::move(init),
+                            op1, op2, proj1, proj2);
+            } else {
+                init = impl(other, other + m, p, p + m, std::move(init),
+                            op1, op2, proj1, proj2);
+            }
+            other += m;
+            n -= m;
+        });
+        return init;
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2,
+        typename T,
+        typename Op1 = std::plus<>,
+        typename Op2 = std::multiplies<>,
+        typename Proj1 = _std::identity,
+        typename Proj2 = _std::identity>
+    constexpr auto operator()(I1 first1, S1 last1,
+                              I2 first2, S2 last2,
+                              T init,
+                              Op1 op1 = Op1{}, Op2 op2 = Op2{},
+                              Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    -> std::enable_if_t<
+        _std::input_iterator<I1> && _std::sentinel_for<S1, I1> &&
+            _std::input_iterator<I2> && _std::sentinel_for<S2, I2>,
+        T>
+    {
+        return impl(std::move(first1), std::move(last1),
+                    std::move(first2), std::move(last2),
+                    std::move(init), op1, op2, proj1, proj2);
+    }
+
+    template <typename R1, typename R2, typename T,
+        typename Op1 = std::plus<>,
+        typename Op2 = std::multiplies<>,
+        typename Proj1 = _std::identity,
+        typename Proj2 = _std::identity>
+    constexpr auto operator()(R1&& r1, R2&& r2, T init,
+                              Op1 op1 = Op1{}, Op2 op2 = Op2{},
+                              Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    -> std::enable_if_t<rng::input_range<R1> && rng::input_range<R2>,
+        T>
+    {
+        if constexpr (is_segmented_range_v<R1> &&
+                      rng::random_access_range<R2> && rng::sized_range<R2>) {
+            if (!detail::is_constant_evaluated()) {
+                return zip_segments<true>([&](auto f) { for_each_segment(r1, f); },
+                                          rng::begin(r2), rng::distance(r2),
+                                          std::move(init), op1, op2, proj1, proj2);
+            }
+        } else if constexpr (is_segmented_range_v<R2> &&
+                             rng::random_access_range<R1> && rng::sized_range<R1>) {
+            if (!detail::is_constant_evaluated()) {
+                return zip_segments<false>([&](auto f) { for_each_segment(r2, f); },
+                                           rng::begin(r1), rng::distance(r1),
+                                           std::move(init), op1, op2, proj1, proj2);
+            }
+        }
+        return impl(rng::begin(r1), rng::end(r1),
+                    rng::begin(r2), rng::end(r2),
+                    std::move(init), op1, op2, proj1, proj2);
+    }
+
+};
+
+using inner_product_fn = basic_inner_product_fn<false>;
+using transform_reduce_fn = basic_inner_product_fn<true>;
+
+} // detail
+
+inline constexpr auto inner_product = detail::inner_product_fn{};
+
+inline constexpr auto transform_reduce = detail::transform_reduce_fn{};
+
+}}
+
+#endif
@@ -0,0 +1,204 @@
+// numeric_ranges/inner_product_batch.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_INNER_PRODUCT_BATCH_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_INNER_PRODUCT_BATCH_HPP_INCLUDED
+
+#include "core.hpp"
+#include "inner_product.hpp"
+
+#ifndef TCB_NUMERIC_RANGES_USE_NANORANGE
+#include <algorithm>
+#endif
+
+namespace tcb {
+inline namespace ranges {
+
+template <typename I, typename O>
+using inner_product_batch_result = rng::copy_result<I, O>;
+
+namespace detail {
+
+// Dot products of one query against R rows at once: each query element is
+// loaded once and multiplied into R sets of lane accumulators, so the rows
+// are the only memory streams. Row r contributes its first n[r] elements.
+// As in dot_kernel, each product is formed in P, the type op2 forms it in.
+template <std::ptrdiff_t R, typename P, typename T, typename Q, typename V>
+void batch_dot_kernel(const Q* query, const V* const* rows,
+                      const std::ptrdiff_t* n, T init, T* results)
+{
+    using A = lane_accumulator_t<T>;
+    // One vector register's worth of lanes per row, so that R rows fit in
+    // registers alongside the query
+    constexpr std::ptrdiff_t L = sizeof(A) < 32 ? 32 / sizeof(A) : 1;
+
+    std::ptrdiff_t common = n[0];
+    const V* rp[R];
+    for (std::ptrdiff_t r = 0; r < R; ++r) {
+        common = n[r] < common ? n[r] : common;
+        rp[r] = rows[r];
+    }
+
+    A acc[R][L] = {};
+    std::ptrdiff_t i = 0;
+    for (; i + L <= common; i += L) {
+#if defined(__GNUC__)
+#pragma GCC unroll 16
+#endif
+        for (std::ptrdiff_t r = 0; r < R; ++r) {
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                acc[r][j] += static_cast<A>(multiply_as<P>(query[i + j], rp[r][i + j]));
+            }
+        }
+    }
+
+    for (std::ptrdiff_t r = 0; r < R; ++r) {
+        A sum = static_cast<A>(init);
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            sum += acc[r][j];
+        }
+        for (std::ptrdiff_t k = i; k < n[r]; ++k) {
+            sum += static_cast<A>(multiply_as<P>(query[k], rows[r][k]));
+        }
+        results[r] = static_cast<T>(sum);
+    }
+}
+
+struct inner_product_batch_fn {
+private:
+    // Number of rows processed together by batch_dot_kernel
+    static constexpr std::ptrdiff_t block_rows = 4;
+
+    template <typename P, typename Q, typename SQ, typename I, typename S,
+              typename O, typename T>
+    static auto kernel_impl(Q qfirst, SQ qlast, I first, S last, O ofirst, T init)
+        -> inner_product_batch_result<I, O>
+    {
+        const auto nq = static_cast<std::ptrdiff_t>(qlast - qfirst);
+        const auto* query = nq > 0 ? std::addressof(*qfirst) : nullptr;
+
+        using V = rng::range_value_t<_std::iter_reference_t<I>>;
+        const V* rows[block_rows];
+        std::ptrdiff_t sizes[block_rows];
+        T results[block_rows];
+        std::ptrdiff_t count = 0;
+
+        const auto flush = [&] {
+            if (count == block_rows) {
+                batch_dot_kernel<block_rows, P>(query, rows, sizes, init, results);
+            } else {
+                for (std::ptrdiff_t r = 0; r < count; ++r) {
+                    batch_dot_kernel<1, P>(query, rows + r, sizes + r, init, results + r);
+                }
+            }
+            for (std::ptrdiff_t r = 0; r < count; ++r) {
+                *ofirst = results[r];
+                ++ofirst;
+            }
+            count = 0;
+        };
+
+        for (; first != last; ++first) {
+            auto&& row = *first;
+            const auto size = static_cast<std::ptrdiff_t>(rng::size(row));
+            rows[count] = size > 0 ? std::addressof(*rng::begin(row)) : nullptr;
+            sizes[count] = size < nq ? size : nq;
+            if (++count == block_rows) {
+                flush();
+            }
+        }
+        flush();
+
+        return {std::move(first), std::move(ofirst)};
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+        typename T,
+        typename Op1 = std::plus<>,
+        typename Op2 = std::multiplies<>,
+        typename Proj1 = _std::identity,
+        typename Proj2 = _std::identity>
+    constexpr auto operator()(I1 first1, S1 last1,
+                              I2 first2, S2 last2,
+                              O ofirst, T init,
+                              Op1 op1 = Op1{}, Op2 op2 = Op2{},
+                              Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    -> std::enable_if_t<
+        _std::forward_iterator<I1> && _std::sentinel_for<S1, I1> &&
+            _std::input_iterator<I2> && _std::sentinel_for<S2, I2>,
+        inner_product_batch_result<I2, O>>
+    {
+        using Row = _std::iter_reference_t<I2>;
+
+        if constexpr (is_contiguous_sized_v<I1, S1> &&
+                      rng::contiguous_range<Row> && rng::sized_range<Row> &&
+                      (std::is_lvalue_reference_v<Row> || rng::borrowed_range<Row>)) {
+            using Q = _std::iter_value_t<I1>;
+            using V = rng::range_value_t<Row>;
+
+            // An integer init takes the kernel only with integer elements,
+            // which it can sum modulo 2^N; the lanes would truncate
+            // floating-point elements one at a time
+            if constexpr (is_lane_summable_v<true, Q, T> &&
+                          is_lane_summable_v<true, V, T> &&
+                          (std::is_floating_point_v<T> || is_wide_integer_v<T>) &&
+                          is_std_op_v<std::plus, Op1, T> &&
+                          is_std_op_v<std::multiplies, Op2, T> &&
+                          std::is_same_v<Proj1, _std::identity> &&
+                          std::is_same_v<Proj2, _std::identity>) {
+                if (!detail::is_constant_evaluated()) {
+                    return kernel_impl<product_t<Op2, Q, V>>(
+                        std::move(first1), std::move(last1),
+                        std::move(first2), std::move(last2),
+                        std::move(ofirst), std::move(init));
+                }
+            }
+        }
+
+        for (; first2 != last2; ++first2) {
+            auto&& row = *first2;
+            *ofirst = inner_product_fn{}(first1, last1,
+                                         rng::begin(row), rng::end(row),
+                                         init, op1, op2, proj1, proj2);
+            ++ofirst;
+        }
+
+        return {std::move(first2), std::move(ofirst)};
+    }
+
+    template <typename R1, typename R2, typename O, typename T,
+        typename Op1 = std::plus<>,
+        typename Op2 = std::multiplies<>,
+        typename Proj1 = _std::identity,
+        typename Proj2 = _std::identity>
+    constexpr auto operator()(R1&& query, R2&& rows, O ofirst, T init,
+                              Op1 op1 = Op1{}, Op2 op2 = Op2{},
+                              Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    -> std::enable_if_t<rng::forward_range<R1> && rng::input_range<R2>,
+        inner_product_batch_result<rng::borrowed_iterator_t<R2>, O>>
+    {
+        return (*this)(rng::begin(query), rng::end(query),
+                       rng::begin(rows), rng::end(rows),
+                       std::move(ofirst), std::move(init),
+                       std::move(op1), std::move(op2),
+                       std::move(proj1), std::move(proj2));
+    }
+};
+
+} // detail
+
+// inner_product_batch(query, rows, out, init) writes inner_product(query,
+// row, init) for each row of rows to out. Contiguous arithmetic rows are
+// processed several at a time, with the sums split across lanes. Each
+// product is still formed as op2 forms it, so integer results are the same
+// as inner_product's (wrapping where its products would overflow), but as
+// with transform_reduce, floating-point results may differ by rounding.
+inline constexpr auto inner_product_batch = detail::inner_product_batch_fn{};
+
+}}
+
+#endif
@@ -0,0 +1,155 @@
+// numeric_ranges/iota.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_IOTA_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_IOTA_HPP_INCLUDED
+
+#include "core.hpp"
+#include "dispatch.hpp"
+#include "segmented.hpp"
+#include "streaming_store.hpp"
+
+namespace tcb {
+inline namespace ranges {
+
+namespace detail {
+
+// Writes value, value + 1, ... computed directly from the index rather than
+// by repeated increments, so that each block of stores is independent
+struct iota_kernel {
+    template <simd_isa, typename E>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static void run(E* out, std::ptrdiff_t n, E value)
+    {
+        using U = std::make_unsigned_t<E>;
+        constexpr std::ptrdiff_t L = kernel_lanes<E>;
+
+        const U base = static_cast<U>(value);
+        std::ptrdiff_t i = 0;
+        for (; i + L <= n; i += L) {
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                out[i + j] = static_cast<E>(base + static_cast<U>(i + j));
+            }
+        }
+        for (; i < n; ++i) {
+            out[i] = static_cast<E>(base + static_cast<U>(i));
+        }
+    }
+};
+
+struct iota_fn {
+
+    template <typename I, typename S, typename T>
+    constexpr I operator()(I first, S last, T value) const
+    {
+        if constexpr (is_streaming_store_v<I>) {
+            return stream(first, std::move(last), std::move(value));
+        } else if constexpr (is_contiguous_sized_v<I, S> && is_lane_integer_v<T>) {
+            if constexpr (std::is_same_v<_std::iter_value_t<I>, T>) {
+                if (!detail::is_constant_evaluated()) {
+                    const auto n = last - first;
+                    if (n > 0) {
+                        dispatch<iota_kernel>(std::addressof(*first),
+                                              static_cast<std::ptrdiff_t>(n),
+                                              value);
+                    }
+                    return first + n;
+                }
+            }
+        } else if constexpr (is_segmented_v<I, S>) {
+            if (!detail::is_constant_evaluated()) {
+                for_each_segment(first, last, [&value](auto* p, auto* q) {
+                    value = fill_segment(p, q, std::move(value));
+                });
+                return last;
+            }
+        }
+
+        while (first != last) {
+            *first = value;
+            ++value;
+            ++first;
+        }
+
+        return first;
+    }
+
+    template <typename R, typename T>
+    constexpr rng::borrowed_iterator_t<R> operator()(R&& r, T value) const
+    {
+        if constexpr (is_segmented_range_v<R>) {
+            if (!detail::is_constant_evaluated()) {
+                for_each_segment(r, [&value](auto* p, auto* q) {
+                    value = fill_segment(p, q, std::move(value));
+                });
+                return segmented_end(r);
+            }
+        }
+        return (*this)(rng::begin(r), rng::end(r), std::move(value));
+    }
+
+private:
+    // Fills one segment of a segmented range, returning the next value
+    template <typename E, typename T>
+    static T fill_segment(E* p, E* q, T value)
+    {
+        const auto n = q - p;
+        if constexpr (std::is_same_v<E, T> && is_lane_integer_v<T>) {
+            dispatch<iota_kernel>(p, n, value);
+            using U = std::make_unsigned_t<T>;
+            return static_cast<T>(static_cast<U>(value) + static_cast<U>(n));
+        } else {
+            for (; p != q; ++p) {
+                *p = value;
+                ++value;
+            }
+            return value;
+        }
+    }
+
+    template <typename E, typename S, typename T>
+    static constexpr streaming_store_iterator<E>
+    stream(streaming_store_iterator<E> first, S last, T value)
+    {
+        if constexpr (std::is_same_v<E, T> && std::is_arithmetic_v<E> &&
+                      !std::is_same_v<E, bool> &&
+                      _std::sized_sentinel_for<S, streaming_store_iterator<E>>) {
+            const auto n = static_cast<std::ptrdiff_t>(last - first);
+            if (!detail::is_constant_evaluated() && first.streams(n)) {
+                stream_blocks(first.base(), n,
+                              [&value](E* stage, std::ptrdiff_t, std::ptrdiff_t m) {
+                    if constexpr (is_lane_integer_v<E>) {
+                        dispatch<iota_kernel>(stage, m, value);
+                        using U = std::make_unsigned_t<E>;
+                        value = static_cast<E>(static_cast<U>(value) + static_cast<U>(m));
+                    } else {
+                        for (std::ptrdiff_t j = 0; j < m; ++j) {
+                            stage[j] = value;
+                            ++value;
+                        }
+                    }
+                });
+                return first + n;
+            }
+        }
+
+        while (first != last) {
+            *first = value;
+            ++value;
+            ++first;
+        }
+
+        return first;
+    }
+};
+
+} // detail
+
+inline constexpr auto iota = detail::iota_fn{};
+
+}}
+
+#endif
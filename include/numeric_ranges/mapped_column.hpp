@@ -0,0 +1,187 @@
+// numeric_ranges/mapped_column.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// A read-only, memory-mapped view of a binary column file. This header is
+// POSIX-only, and is not included by numeric_ranges.hpp.
+
+#ifndef TCB_NUMERIC_RANGES_MAPPED_COLUMN_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_MAPPED_COLUMN_HPP_INCLUDED
+
+#include "core.hpp"
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tcb {
+inline namespace ranges {
+
+// A contiguous range of the Ts stored in a file, which must contain nothing
+// but a packed array of T in the host's byte order. The file is mapped into
+// memory rather than read, so passing a mapped_column to an algorithm
+// reduces the file in place, with no copying and no intermediate buffers,
+// and the algorithms' contiguous fast paths apply as they would to a
+// vector.
+//
+// The mapping is advised for sequential access, which lets the kernel read
+// ahead aggressively and drop pages behind the scan, and for transparent
+// huge pages where the filesystem supports them. The first `readahead`
+// bytes are requested up front; later regions can be requested with
+// will_need() before they are reached.
+//
+// Construction throws std::system_error if the file cannot be opened or
+// mapped, or if its size is not a multiple of sizeof(T).
+template <typename T>
+class mapped_column {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "mapped_column<T> requires a trivially copyable T");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator = const T*;
+    using const_iterator = const T*;
+
+    static constexpr std::size_t default_readahead = std::size_t{64} << 20;
+
+    mapped_column() = default;
+
+    explicit mapped_column(const char* path,
+                           std::size_t readahead = default_readahead)
+    {
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw_errno("open", path);
+        }
+
+        struct ::stat st{};
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw_errno("stat", path, err);
+        }
+
+        const auto bytes = static_cast<std::size_t>(st.st_size);
+        if (bytes % sizeof(T) != 0) {
+            ::close(fd);
+            throw std::system_error(
+                std::make_error_code(std::errc::invalid_argument),
+                std::string("mapped_column: size of ") + path +
+                    " is not a multiple of the element size");
+        }
+
+        // mmap() rejects empty mappings, so an empty file is simply an
+        // empty column
+        if (bytes != 0) {
+            void* addr = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                const int err = errno;
+                ::close(fd);
+                throw_errno("mmap", path, err);
+            }
+            data_ = static_cast<const T*>(addr);
+            size_ = bytes / sizeof(T);
+        }
+
+        // The mapping holds its own reference to the file
+        ::close(fd);
+
+        if (size_ != 0) {
+            // These are only hints: failure leaves a working mapping
+            ::madvise(mapping(), bytes, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+            ::madvise(mapping(), bytes, MADV_HUGEPAGE);
+#endif
+            will_need(0, readahead / sizeof(T));
+        }
+    }
+
+    explicit mapped_column(const std::string& path,
+                           std::size_t readahead = default_readahead)
+        : mapped_column(path.c_str(), readahead)
+    {}
+
+    mapped_column(mapped_column&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0))
+    {}
+
+    mapped_column& operator=(mapped_column&& other) noexcept
+    {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~mapped_column() { unmap(); }
+
+    const T* begin() const noexcept { return data_; }
+    const T* end() const noexcept { return data_ + size_; }
+    const T* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    // Precondition: idx < size()
+    const T& operator[](std::size_t idx) const noexcept { return data_[idx]; }
+
+    // Asks the kernel to start reading the elements [first, first + count)
+    // in the background. Out-of-range parts of the request are ignored.
+    void will_need(std::size_t first, std::size_t count) const noexcept
+    {
+        if (first >= size_ || count == 0) {
+            return;
+        }
+        if (count > size_ - first) {
+            count = size_ - first;
+        }
+
+        // madvise() needs a page-aligned start address
+        static const auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+        const auto start = reinterpret_cast<std::uintptr_t>(data_ + first);
+        const auto aligned = start & ~(page - 1);
+        const auto stop = reinterpret_cast<std::uintptr_t>(data_ + first + count);
+        ::madvise(reinterpret_cast<void*>(aligned), stop - aligned, MADV_WILLNEED);
+    }
+
+private:
+    [[noreturn]] static void throw_errno(const char* what, const char* path,
+                                         int err = errno)
+    {
+        throw std::system_error(err, std::generic_category(),
+                                std::string("mapped_column: ") + what + " " + path);
+    }
+
+    void* mapping() const noexcept
+    {
+        return const_cast<void*>(static_cast<const void*>(data_));
+    }
+
+    void unmap() noexcept
+    {
+        if (data_ != nullptr) {
+            ::munmap(mapping(), size_ * sizeof(T));
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    const T* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace ranges
+} // namespace tcb
+
+#endif
@@ -0,0 +1,396 @@
+// numeric_ranges/minmax_reduce.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_MINMAX_REDUCE_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_MINMAX_REDUCE_HPP_INCLUDED
+
+#include "core.hpp"
+
+#ifndef TCB_NUMERIC_RANGES_USE_NANORANGE
+#include <algorithm>
+#endif
+
+#include <limits>
+
+namespace tcb {
+inline namespace ranges {
+
+template <typename T>
+using minmax_reduce_result = rng::minmax_result<T>;
+
+namespace detail {
+
+// The starting values used by min_reduce and max_reduce when no init is
+// given, so that an empty range yields a value no element can improve on.
+// They come from numeric_limits, so other types must be given an init.
+template <typename T>
+inline constexpr bool has_identity_v = std::numeric_limits<T>::is_specialized;
+
+template <typename T>
+constexpr T min_identity()
+{
+    if constexpr (std::numeric_limits<T>::has_infinity) {
+        return std::numeric_limits<T>::infinity();
+    } else {
+        return (std::numeric_limits<T>::max)();
+    }
+}
+
+template <typename T>
+constexpr T max_identity()
+{
+    if constexpr (std::numeric_limits<T>::has_infinity) {
+        return -std::numeric_limits<T>::infinity();
+    } else {
+        return std::numeric_limits<T>::lowest();
+    }
+}
+
+// Whether x should replace best: written as a plain ternary-friendly
+// comparison so that it lowers to vector min/max instructions, which
+// share its behaviour of keeping best when either operand is NaN
+template <bool Max, typename T>
+constexpr bool improves(const T& x, const T& best)
+{
+    if constexpr (Max) {
+        return best < x;
+    } else {
+        return x < best;
+    }
+}
+
+// The lanes keep the first of equal values each sees, but merging them
+// need not keep the first overall. Equal arithmetic values differ only as
+// zeros of opposite sign, so a zero result is replaced by the zero that a
+// sequential scan keeps: init if it is zero, else the first zero element.
+template <typename T>
+T first_zero(const T* data, T init, T res)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        if (res == T(0) && !(init == T(0))) {
+            while (!(*data == T(0))) {
+                ++data;
+            }
+            return *data;
+        }
+    }
+    return res;
+}
+
+template <bool Max, typename T>
+T extremum_kernel(const T* data, std::ptrdiff_t n, T init)
+{
+    constexpr std::ptrdiff_t L = kernel_lanes<T>;
+
+    const T start = init;
+    T best[L];
+    for (std::ptrdiff_t j = 0; j < L; ++j) {
+        best[j] = init;
+    }
+
+    std::ptrdiff_t i = 0;
+    for (; i + L <= n; i += L) {
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            best[j] = improves<Max>(data[i + j], best[j]) ? data[i + j] : best[j];
+        }
+    }
+
+    for (std::ptrdiff_t j = 0; j < L; ++j) {
+        init = improves<Max>(best[j], init) ? best[j] : init;
+    }
+    init = first_zero(data, start, init);
+    for (; i < n; ++i) {
+        init = improves<Max>(data[i], init) ? data[i] : init;
+    }
+
+    return init;
+}
+
+template <typename T>
+minmax_reduce_result<T> minmax_kernel(const T* data, std::ptrdiff_t n,
+                                      minmax_reduce_result<T> init)
+{
+    constexpr std::ptrdiff_t L = kernel_lanes<T>;
+
+    const minmax_reduce_result<T> start = init;
+    T lo[L];
+    T hi[L];
+    for (std::ptrdiff_t j = 0; j < L; ++j) {
+        lo[j] = init.min;
+        hi[j] = init.max;
+    }
+
+    std::ptrdiff_t i = 0;
+    for (; i + L <= n; i += L) {
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            lo[j] = improves<false>(data[i + j], lo[j]) ? data[i + j] : lo[j];
+            hi[j] = improves<true>(data[i + j], hi[j]) ? data[i + j] : hi[j];
+        }
+    }
+
+    for (std::ptrdiff_t j = 0; j < L; ++j) {
+        init.min = improves<false>(lo[j], init.min) ? lo[j] : init.min;
+        init.max = improves<true>(hi[j], init.max) ? hi[j] : init.max;
+    }
+    init.min = first_zero(data, start.min, init.min);
+    init.max = first_zero(data, start.max, init.max);
+    for (; i < n; ++i) {
+        init.min = improves<false>(data[i], init.min) ? data[i] : init.min;
+        init.max = improves<true>(data[i], init.max) ? data[i] : init.max;
+    }
+
+    return init;
+}
+
+// Returns the index of the first minimum (or maximum) of a non-empty array.
+// Every lane starts out holding element 0, so a NaN can only ever be
+// selected if it is the first element, exactly as for min_element.
+template <bool Max, typename T>
+std::ptrdiff_t arg_extremum_kernel(const T* data, std::ptrdiff_t n)
+{
+    constexpr std::ptrdiff_t L = kernel_lanes<T>;
+
+    T best[L];
+    std::ptrdiff_t idx[L];
+    for (std::ptrdiff_t j = 0; j < L; ++j) {
+        best[j] = data[0];
+        idx[j] = 0;
+    }
+
+    std::ptrdiff_t i = 0;
+    for (; i + L <= n; i += L) {
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            const bool b = improves<Max>(data[i + j], best[j]);
+            best[j] = b ? data[i + j] : best[j];
+            idx[j] = b ? i + j : idx[j];
+        }
+    }
+
+    // Each lane holds the first extremum it saw, so ties between lanes go
+    // to the lowest index
+    T res = best[0];
+    std::ptrdiff_t res_idx = idx[0];
+    for (std::ptrdiff_t j = 1; j < L; ++j) {
+        if (improves<Max>(best[j], res) || (best[j] == res && idx[j] < res_idx)) {
+            res = best[j];
+            res_idx = idx[j];
+        }
+    }
+    for (; i < n; ++i) {
+        if (improves<Max>(data[i], res)) {
+            res = data[i];
+            res_idx = i;
+        }
+    }
+
+    return res_idx;
+}
+
+template <bool Max>
+struct extremum_reduce_fn {
+
+    template <typename I, typename S>
+    constexpr auto operator()(I first, S last) const
+    -> std::enable_if_t<_std::input_iterator<I> && _std::sentinel_for<S, I> &&
+                        has_identity_v<_std::iter_value_t<I>>,
+        _std::iter_value_t<I>>
+    {
+        using T = _std::iter_value_t<I>;
+        return (*this)(std::move(first), std::move(last),
+                       Max ? max_identity<T>() : min_identity<T>());
+    }
+
+    template <typename I, typename S,
+        typename T = _std::iter_value_t<I>,
+        typename Comp = rng::less,
+        typename Proj = _std::identity>
+    constexpr auto operator()(I first, S last, T init,
+                              Comp comp = Comp{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<_std::input_iterator<I> && _std::sentinel_for<S, I>, T>
+    {
+        if constexpr (is_contiguous_sized_v<I, S> &&
+                      std::is_same_v<Proj, _std::identity> &&
+                      std::is_arithmetic_v<T> &&
+                      std::is_same_v<_std::iter_value_t<I>, T> &&
+                      is_default_less_v<Comp, T>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = static_cast<std::ptrdiff_t>(last - first);
+                if (n == 0) {
+                    return init;
+                }
+                return extremum_kernel<Max>(std::addressof(*first), n, init);
+            }
+        }
+
+        while (first != last) {
+            auto&& x = _std::invoke(proj, *first);
+            if (Max ? _std::invoke(comp, init, x) : _std::invoke(comp, x, init)) {
+                init = std::forward<decltype(x)>(x);
+            }
+            ++first;
+        }
+
+        return init;
+    }
+
+    template <typename R>
+    constexpr auto operator()(R&& r) const
+    -> std::enable_if_t<rng::input_range<R> && has_identity_v<rng::range_value_t<R>>,
+        rng::range_value_t<R>>
+    {
+        return (*this)(rng::begin(r), rng::end(r));
+    }
+
+    template <typename R,
+        typename T = rng::range_value_t<R>,
+        typename Comp = rng::less,
+        typename Proj = _std::identity>
+    constexpr auto operator()(R&& r, T init,
+                              Comp comp = Comp{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<rng::input_range<R>, T>
+    {
+        return (*this)(rng::begin(r), rng::end(r),
+                       std::move(init), std::move(comp), std::move(proj));
+    }
+};
+
+struct minmax_reduce_fn {
+
+    template <typename I, typename S>
+    constexpr auto operator()(I first, S last) const
+    -> std::enable_if_t<_std::input_iterator<I> && _std::sentinel_for<S, I> &&
+                        has_identity_v<_std::iter_value_t<I>>,
+        minmax_reduce_result<_std::iter_value_t<I>>>
+    {
+        using T = _std::iter_value_t<I>;
+        return (*this)(std::move(first), std::move(last),
+                       minmax_reduce_result<T>{min_identity<T>(), max_identity<T>()});
+    }
+
+    template <typename I, typename S,
+        typename T = _std::iter_value_t<I>,
+        typename Comp = rng::less,
+        typename Proj = _std::identity>
+    constexpr auto operator()(I first, S last, minmax_reduce_result<T> init,
+                              Comp comp = Comp{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<_std::input_iterator<I> && _std::sentinel_for<S, I>,
+        minmax_reduce_result<T>>
+    {
+        if constexpr (is_contiguous_sized_v<I, S> &&
+                      std::is_same_v<Proj, _std::identity> &&
+                      std::is_arithmetic_v<T> &&
+                      std::is_same_v<_std::iter_value_t<I>, T> &&
+                      is_default_less_v<Comp, T>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = static_cast<std::ptrdiff_t>(last - first);
+                if (n == 0) {
+                    return init;
+                }
+                return minmax_kernel(std::addressof(*first), n, std::move(init));
+            }
+        }
+
+        while (first != last) {
+            auto&& x = _std::invoke(proj, *first);
+            if (_std::invoke(comp, x, init.min)) {
+                init.min = x;
+            }
+            if (_std::invoke(comp, init.max, x)) {
+                init.max = std::forward<decltype(x)>(x);
+            }
+            ++first;
+        }
+
+        return init;
+    }
+
+    template <typename R>
+    constexpr auto operator()(R&& r) const
+    -> std::enable_if_t<rng::input_range<R> && has_identity_v<rng::range_value_t<R>>,
+        minmax_reduce_result<rng::range_value_t<R>>>
+    {
+        return (*this)(rng::begin(r), rng::end(r));
+    }
+
+    template <typename R,
+        typename T = rng::range_value_t<R>,
+        typename Comp = rng::less,
+        typename Proj = _std::identity>
+    constexpr auto operator()(R&& r, minmax_reduce_result<T> init,
+                              Comp comp = Comp{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<rng::input_range<R>, minmax_reduce_result<T>>
+    {
+        return (*this)(rng::begin(r), rng::end(r),
+                       std::move(init), std::move(comp), std::move(proj));
+    }
+};
+
+template <bool Max>
+struct arg_extremum_fn {
+
+    template <typename I, typename S,
+        typename Comp = rng::less,
+        typename Proj = _std::identity>
+    constexpr auto operator()(I first, S last,
+                              Comp comp = Comp{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<_std::forward_iterator<I> && _std::sentinel_for<S, I>, I>
+    {
+        using V = _std::iter_value_t<I>;
+
+        if constexpr (is_contiguous_sized_v<I, S> &&
+                      std::is_same_v<Proj, _std::identity> &&
+                      std::is_arithmetic_v<V> &&
+                      is_default_less_v<Comp, V>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = static_cast<std::ptrdiff_t>(last - first);
+                if (n == 0) {
+                    return first;
+                }
+                return first + arg_extremum_kernel<Max>(std::addressof(*first), n);
+            }
+        }
+
+        if (first == last) {
+            return first;
+        }
+
+        I best = first;
+        while (++first != last) {
+            if (Max ? _std::invoke(comp, _std::invoke(proj, *best), _std::invoke(proj, *first))
+                    : _std::invoke(comp, _std::invoke(proj, *first), _std::invoke(proj, *best))) {
+                best = first;
+            }
+        }
+
+        return best;
+    }
+
+    template <typename R,
+        typename Comp = rng::less,
+        typename Proj = _std::identity>
+    constexpr auto operator()(R&& r, Comp comp = Comp{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<rng::forward_range<R>, rng::borrowed_iterator_t<R>>
+    {
+        return (*this)(rng::begin(r), rng::end(r),
+                       std::move(comp), std::move(proj));
+    }
+};
+
+} // detail
+
+inline constexpr auto min_reduce = detail::extremum_reduce_fn<false>{};
+
+inline constexpr auto max_reduce = detail::extremum_reduce_fn<true>{};
+
+inline constexpr auto minmax_reduce = detail::minmax_reduce_fn{};
+
+inline constexpr auto argmin = detail::arg_extremum_fn<false>{};
+
+inline constexpr auto argmax = detail::arg_extremum_fn<true>{};
+
+}}
+
+#endif
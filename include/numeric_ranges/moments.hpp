@@ -0,0 +1,261 @@
+// numeric_ranges/moments.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_MOMENTS_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_MOMENTS_HPP_INCLUDED
+
+#include "core.hpp"
+
+#include <cmath>
+
+namespace tcb {
+inline namespace ranges {
+
+// Running count, mean and sum of squared deviations (M2) of a sequence,
+// updated with Welford's algorithm. Two results computed over disjoint parts
+// of a sequence can be combined with merge() (Chan et al.), so partial
+// results from separate threads or SIMD lanes can be reduced at the end.
+template <typename T>
+struct moments_result {
+    std::ptrdiff_t count = 0;
+    T mean = T{};
+    T m2 = T{};
+
+    constexpr void push(T x)
+    {
+        ++count;
+        const T delta = x - mean;
+        mean += delta / static_cast<T>(count);
+        m2 += delta * (x - mean);
+    }
+
+    constexpr moments_result& merge(const moments_result& other)
+    {
+        if (other.count == 0) {
+            return *this;
+        }
+        if (count == 0) {
+            return *this = other;
+        }
+
+        const T na = static_cast<T>(count);
+        const T nb = static_cast<T>(other.count);
+        const T n = na + nb;
+        const T delta = other.mean - mean;
+
+        count += other.count;
+        mean += delta * nb / n;
+        m2 += other.m2 + delta * delta * na * nb / n;
+        return *this;
+    }
+
+    constexpr T variance() const
+    {
+        return count > 0 ? m2 / static_cast<T>(count) : T{};
+    }
+
+    constexpr T sample_variance() const
+    {
+        return count > 1 ? m2 / static_cast<T>(count - 1) : T{};
+    }
+};
+
+// As moments_result, additionally tracking the third and fourth central
+// moment sums (M3, M4) using the update and merge formulae of Pebay (2008).
+template <typename T>
+struct higher_moments_result {
+    std::ptrdiff_t count = 0;
+    T mean = T{};
+    T m2 = T{};
+    T m3 = T{};
+    T m4 = T{};
+
+    constexpr void push(T x)
+    {
+        const T n1 = static_cast<T>(count);
+        ++count;
+        const T n = static_cast<T>(count);
+        const T delta = x - mean;
+        const T delta_n = delta / n;
+        const T delta_n2 = delta_n * delta_n;
+        const T term1 = delta * delta_n * n1;
+
+        mean += delta_n;
+        m4 += term1 * delta_n2 * (n * n - 3 * n + 3) + 6 * delta_n2 * m2
+              - 4 * delta_n * m3;
+        m3 += term1 * delta_n * (n - 2) - 3 * delta_n * m2;
+        m2 += term1;
+    }
+
+    constexpr higher_moments_result& merge(const higher_moments_result& other)
+    {
+        if (other.count == 0) {
+            return *this;
+        }
+        if (count == 0) {
+            return *this = other;
+        }
+
+        const T na = static_cast<T>(count);
+        const T nb = static_cast<T>(other.count);
+        const T n = na + nb;
+        const T delta = other.mean - mean;
+        const T delta2 = delta * delta;
+
+        const T new_m4 = m4 + other.m4
+            + delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n)
+            + 6 * delta2 * (na * na * other.m2 + nb * nb * m2) / (n * n)
+            + 4 * delta * (na * other.m3 - nb * m3) / n;
+        const T new_m3 = m3 + other.m3
+            + delta2 * delta * na * nb * (na - nb) / (n * n)
+            + 3 * delta * (na * other.m2 - nb * m2) / n;
+
+        count += other.count;
+        mean += delta * nb / n;
+        m2 += other.m2 + delta2 * na * nb / n;
+        m3 = new_m3;
+        m4 = new_m4;
+        return *this;
+    }
+
+    constexpr T variance() const
+    {
+        return count > 0 ? m2 / static_cast<T>(count) : T{};
+    }
+
+    constexpr T sample_variance() const
+    {
+        return count > 1 ? m2 / static_cast<T>(count - 1) : T{};
+    }
+
+    T skewness() const
+    {
+        using std::sqrt;
+        return sqrt(static_cast<T>(count)) * m3 / (m2 * sqrt(m2));
+    }
+
+    // Excess kurtosis (zero for a normal distribution)
+    T kurtosis() const
+    {
+        return static_cast<T>(count) * m4 / (m2 * m2) - 3;
+    }
+};
+
+namespace detail {
+
+template <typename V>
+using moments_value_t = std::conditional_t<std::is_floating_point_v<V>, V, double>;
+
+// Runs kernel_lanes<T> independent Welford updates over interleaved elements,
+// all lanes sharing the same count so that the reciprocal is computed once
+// per block, then merges the lanes and folds in the tail.
+template <typename Result, typename V>
+Result moments_kernel(const V* data, std::ptrdiff_t n)
+{
+    using T = decltype(Result{}.mean);
+    constexpr std::ptrdiff_t L = kernel_lanes<T>;
+
+    T mean[L] = {};
+    T m2[L] = {};
+    [[maybe_unused]] T m3[L] = {};
+    [[maybe_unused]] T m4[L] = {};
+    constexpr bool higher = std::is_same_v<Result, higher_moments_result<T>>;
+
+    const std::ptrdiff_t blocks = n / L;
+    for (std::ptrdiff_t b = 0; b < blocks; ++b, data += L) {
+        const T n1 = static_cast<T>(b);
+        const T nn = static_cast<T>(b + 1);
+        const T inv = T(1) / nn;
+
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            const T x = static_cast<T>(data[j]);
+            const T delta = x - mean[j];
+            const T delta_n = delta * inv;
+            if constexpr (higher) {
+                const T delta_n2 = delta_n * delta_n;
+                const T term1 = delta * delta_n * n1;
+                m4[j] += term1 * delta_n2 * (nn * nn - 3 * nn + 3)
+                         + 6 * delta_n2 * m2[j] - 4 * delta_n * m3[j];
+                m3[j] += term1 * delta_n * (nn - 2) - 3 * delta_n * m2[j];
+                m2[j] += term1;
+                mean[j] += delta_n;
+            } else {
+                mean[j] += delta_n;
+                m2[j] += delta * (x - mean[j]);
+            }
+        }
+    }
+
+    Result res{};
+    for (std::ptrdiff_t j = 0; j < L; ++j) {
+        Result lane{};
+        lane.count = blocks;
+        lane.mean = mean[j];
+        lane.m2 = m2[j];
+        if constexpr (higher) {
+            lane.m3 = m3[j];
+            lane.m4 = m4[j];
+        }
+        res.merge(lane);
+    }
+
+    for (std::ptrdiff_t i = blocks * L; i < n; ++i) {
+        res.push(static_cast<T>(*data++));
+    }
+
+    return res;
+}
+
+template <template <typename> class Result>
+struct moments_fn {
+
+    template <typename I, typename S, typename Proj = _std::identity>
+    constexpr auto operator()(I first, S last, Proj proj = Proj{}) const
+    -> std::enable_if_t<_std::input_iterator<I> && _std::sentinel_for<S, I>,
+        Result<moments_value_t<projected_value_t<Proj, I>>>>
+    {
+        using V = projected_value_t<Proj, I>;
+        using T = moments_value_t<V>;
+
+        if constexpr (is_contiguous_sized_v<I, S> &&
+                      std::is_same_v<Proj, _std::identity> &&
+                      std::is_arithmetic_v<V>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = static_cast<std::ptrdiff_t>(last - first);
+                if (n == 0) {
+                    return Result<T>{};
+                }
+                return moments_kernel<Result<T>>(std::addressof(*first), n);
+            }
+        }
+
+        Result<T> res{};
+        while (first != last) {
+            res.push(static_cast<T>(_std::invoke(proj, *first)));
+            ++first;
+        }
+
+        return res;
+    }
+
+    template <typename R, typename Proj = _std::identity>
+    constexpr auto operator()(R&& r, Proj proj = Proj{}) const
+    -> std::enable_if_t<rng::input_range<R>,
+        Result<moments_value_t<projected_value_t<Proj, rng::iterator_t<R>>>>>
+    {
+        return (*this)(rng::begin(r), rng::end(r), std::move(proj));
+    }
+};
+
+} // detail
+
+inline constexpr auto moments = detail::moments_fn<moments_result>{};
+
+inline constexpr auto higher_moments = detail::moments_fn<higher_moments_result>{};
+
+}}
+
+#endif
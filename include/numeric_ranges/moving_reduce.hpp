@@ -0,0 +1,409 @@
+// numeric_ranges/moving_reduce.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_MOVING_REDUCE_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_MOVING_REDUCE_HPP_INCLUDED
+
+#include "core.hpp"
+
+#include <new>
+#include <optional>
+
+#ifndef TCB_NUMERIC_RANGES_USE_NANORANGE
+#include <algorithm>
+#endif
+
+namespace tcb {
+inline namespace ranges {
+
+template <typename I, typename O>
+using moving_reduce_result = rng::copy_result<I, O>;
+
+// Fixed-capacity circular buffer. Storage is allocated once, when the
+// buffer is constructed (or reset() to a larger capacity), so a buffer can
+// be reused across many sequences without further allocation. Elements are
+// constructed as they are pushed and destroyed as they are popped, so T
+// need not be default constructible.
+template <typename T>
+class ring_buffer {
+public:
+    ring_buffer() = default;
+
+    explicit ring_buffer(std::size_t capacity)
+    {
+        reset(capacity);
+    }
+
+    ring_buffer(ring_buffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          head_(std::exchange(other.head_, 0)),
+          size_(std::exchange(other.size_, 0))
+    {}
+
+    ring_buffer& operator=(ring_buffer&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            capacity_ = std::exchange(other.capacity_, 0);
+            head_ = std::exchange(other.head_, 0);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~ring_buffer() { release(); }
+
+    // Empties the buffer, reallocating only if the capacity must grow
+    void reset(std::size_t capacity)
+    {
+        clear();
+        if (capacity > capacity_) {
+            std::size_t cap = 1;
+            while (cap < capacity) {
+                cap *= 2;
+            }
+            T* data = std::allocator<T>{}.allocate(cap);
+            release();
+            data_ = data;
+            capacity_ = cap;
+        }
+    }
+
+    void clear() noexcept
+    {
+        while (size_ > 0) {
+            pop_back();
+        }
+        head_ = 0;
+    }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    // Precondition: size() < capacity()
+    template <typename U>
+    void push_back(U&& value)
+    {
+        ::new (static_cast<void*>(data_ + ((head_ + size_) & (capacity_ - 1))))
+            T(std::forward<U>(value));
+        ++size_;
+    }
+
+    void pop_front() noexcept
+    {
+        std::destroy_at(data_ + head_);
+        head_ = (head_ + 1) & (capacity_ - 1);
+        --size_;
+    }
+
+    void pop_back() noexcept
+    {
+        --size_;
+        std::destroy_at(data_ + ((head_ + size_) & (capacity_ - 1)));
+    }
+
+    T& operator[](std::size_t i) { return data_[(head_ + i) & (capacity_ - 1)]; }
+    const T& operator[](std::size_t i) const { return data_[(head_ + i) & (capacity_ - 1)]; }
+
+    T& front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+    T& back() { return (*this)[size_ - 1]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+private:
+    void release() noexcept
+    {
+        clear();
+        if (data_) {
+            std::allocator<T>{}.deallocate(data_, capacity_);
+            data_ = nullptr;
+            capacity_ = 0;
+        }
+    }
+
+    T* data_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+};
+
+// The minimum (with respect to Comp) of the last `window` values pushed,
+// maintained with a monotonic deque: each push and query is O(1) amortised.
+template <typename T, typename Comp = rng::less>
+class monotonic_window {
+public:
+    explicit monotonic_window(std::ptrdiff_t window, Comp comp = Comp{})
+        : deque_(static_cast<std::size_t>(window)),
+          window_(window),
+          comp_(std::move(comp))
+    {}
+
+    std::ptrdiff_t window() const noexcept { return window_; }
+
+    // Number of values pushed since construction or the last reset()
+    std::ptrdiff_t count() const noexcept { return count_; }
+
+    void reset() noexcept
+    {
+        deque_.clear();
+        count_ = 0;
+    }
+
+    template <typename U>
+    void push(U&& value)
+    {
+        if (!deque_.empty() && deque_.front().first <= count_ - window_) {
+            deque_.pop_front();
+        }
+        while (!deque_.empty() && !_std::invoke(comp_, deque_.back().second, value)) {
+            deque_.pop_back();
+        }
+        deque_.push_back(std::pair<std::ptrdiff_t, T>(count_, std::forward<U>(value)));
+        ++count_;
+    }
+
+    // Precondition: count() > 0
+    const T& value() const { return deque_.front().second; }
+
+private:
+    ring_buffer<std::pair<std::ptrdiff_t, T>> deque_;
+    std::ptrdiff_t window_;
+    std::ptrdiff_t count_ = 0;
+    Comp comp_;
+};
+
+// The fold with an associative (not necessarily commutative) Op of the last
+// `window` values pushed, in order, using the "two stacks" queue: values
+// leave from a front stack holding suffix aggregates, and arrive on a back
+// stack summarised by a single running aggregate. When the front stack
+// runs out the back stack is flipped over, so each value is combined O(1)
+// times on average. T need not be default constructible.
+template <typename T, typename Op>
+class two_stacks_window {
+public:
+    explicit two_stacks_window(std::ptrdiff_t window, Op op = Op{})
+        : values_(static_cast<std::size_t>(window)),
+          front_aggs_(static_cast<std::size_t>(window)),
+          window_(window),
+          op_(std::move(op))
+    {}
+
+    std::ptrdiff_t window() const noexcept { return window_; }
+
+    // Number of values pushed since construction or the last reset()
+    std::ptrdiff_t count() const noexcept { return count_; }
+
+    void reset() noexcept
+    {
+        values_.clear();
+        front_aggs_.clear();
+        back_agg_.reset();
+        front_size_ = 0;
+        count_ = 0;
+    }
+
+    template <typename U>
+    void push(U&& value)
+    {
+        if (static_cast<std::ptrdiff_t>(values_.size()) == window_) {
+            pop();
+        }
+        if (values_.size() == front_size_) {
+            back_agg_.emplace(value);
+        } else {
+            *back_agg_ = _std::invoke(op_, std::move(*back_agg_), value);
+        }
+        values_.push_back(std::forward<U>(value));
+        ++count_;
+    }
+
+    // Precondition: count() > 0
+    T value() const
+    {
+        if (front_size_ == 0) {
+            return *back_agg_;
+        }
+        if (values_.size() == front_size_) {
+            return front_aggs_.front();
+        }
+        return _std::invoke(op_, front_aggs_.front(), *back_agg_);
+    }
+
+private:
+    void pop()
+    {
+        if (front_size_ == 0) {
+            const std::size_t n = values_.size();
+            front_aggs_.clear();
+            for (std::size_t i = 0; i < n; ++i) {
+                front_aggs_.push_back(values_[i]);
+            }
+            for (std::size_t i = n - 1; i-- > 0; ) {
+                front_aggs_[i] = _std::invoke(op_, std::move(front_aggs_[i]),
+                                              front_aggs_[i + 1]);
+            }
+            front_size_ = n;
+        }
+        values_.pop_front();
+        front_aggs_.pop_front();
+        --front_size_;
+    }
+
+    ring_buffer<T> values_;
+    ring_buffer<T> front_aggs_;
+    std::optional<T> back_agg_;
+    std::size_t front_size_ = 0;
+    std::ptrdiff_t window_;
+    std::ptrdiff_t count_ = 0;
+    Op op_;
+};
+
+namespace detail {
+
+// Swaps the arguments of a comparator, so that a window keeping the
+// "least" element keeps the greatest instead
+template <typename Comp>
+struct flipped {
+    Comp comp;
+
+    template <typename T, typename U>
+    constexpr decltype(auto) operator()(T&& t, U&& u) const
+    {
+        return _std::invoke(comp, std::forward<U>(u), std::forward<T>(t));
+    }
+};
+
+// True if a sized input is shorter than the window. No window of it then
+// completes, so the algorithms return without building (and allocating) a
+// window object; otherwise the window is no longer than the input.
+template <typename I, typename S, typename D>
+constexpr bool shorter_than_window(const I& first, const S& last, D w)
+{
+    if constexpr (_std::sized_sentinel_for<S, I>) {
+        return last - first < w;
+    } else {
+        return false;
+    }
+}
+
+template <typename R, typename D>
+constexpr bool shorter_than_window(R& r, D w)
+{
+    if constexpr (rng::sized_range<R>) {
+        return rng::distance(r) < w;
+    } else {
+        return false;
+    }
+}
+
+// Feeds each projected element through a window object, writing its value
+// once the first `w` elements have been seen
+template <typename Window, typename I, typename S, typename O, typename Proj>
+auto moving_window_impl(Window&& window, I first, S last, O ofirst, Proj& proj)
+    -> moving_reduce_result<I, O>
+{
+    const auto w = window.window();
+    for (; first != last; ++first) {
+        window.push(_std::invoke(proj, *first));
+        if (window.count() >= w) {
+            *ofirst = window.value();
+            ++ofirst;
+        }
+    }
+
+    return {std::move(first), std::move(ofirst)};
+}
+
+template <bool Max>
+struct moving_extremum_fn {
+
+    template <typename I, typename S, typename O,
+        typename Comp = rng::less, typename Proj = _std::identity>
+    auto operator()(I first, S last, _std::iter_difference_t<I> w, O ofirst,
+                    Comp comp = Comp{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<_std::input_iterator<I> && _std::sentinel_for<S, I>,
+        moving_reduce_result<I, O>>
+    {
+        using V = projected_value_t<Proj, I>;
+
+        if (w <= 0 || shorter_than_window(first, last, w)) {
+            return {rng::next(std::move(first), last), std::move(ofirst)};
+        }
+
+        if constexpr (Max) {
+            return moving_window_impl(
+                monotonic_window<V, flipped<Comp>>(w, flipped<Comp>{std::move(comp)}),
+                std::move(first), std::move(last), std::move(ofirst), proj);
+        } else {
+            return moving_window_impl(
+                monotonic_window<V, Comp>(w, std::move(comp)),
+                std::move(first), std::move(last), std::move(ofirst), proj);
+        }
+    }
+
+    template <typename R, typename O,
+        typename Comp = rng::less, typename Proj = _std::identity>
+    auto operator()(R&& r, rng::range_difference_t<R> w, O ofirst,
+                    Comp comp = Comp{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<rng::input_range<R>,
+        moving_reduce_result<rng::borrowed_iterator_t<R>, O>>
+    {
+        if (shorter_than_window(r, w)) {
+            return {rng::next(rng::begin(r), rng::end(r)), std::move(ofirst)};
+        }
+        return (*this)(rng::begin(r), rng::end(r), w, std::move(ofirst),
+                       std::move(comp), std::move(proj));
+    }
+};
+
+struct moving_reduce_fn {
+
+    template <typename I, typename S, typename O,
+        typename Op, typename Proj = _std::identity>
+    auto operator()(I first, S last, _std::iter_difference_t<I> w, O ofirst,
+                    Op op, Proj proj = Proj{}) const
+    -> std::enable_if_t<_std::input_iterator<I> && _std::sentinel_for<S, I>,
+        moving_reduce_result<I, O>>
+    {
+        using V = projected_value_t<Proj, I>;
+
+        if (w <= 0 || shorter_than_window(first, last, w)) {
+            return {rng::next(std::move(first), last), std::move(ofirst)};
+        }
+
+        return moving_window_impl(two_stacks_window<V, Op>(w, std::move(op)),
+                                  std::move(first), std::move(last),
+                                  std::move(ofirst), proj);
+    }
+
+    template <typename R, typename O, typename Op, typename Proj = _std::identity>
+    auto operator()(R&& r, rng::range_difference_t<R> w, O ofirst,
+                    Op op, Proj proj = Proj{}) const
+    -> std::enable_if_t<rng::input_range<R>,
+        moving_reduce_result<rng::borrowed_iterator_t<R>, O>>
+    {
+        if (shorter_than_window(r, w)) {
+            return {rng::next(rng::begin(r), rng::end(r)), std::move(ofirst)};
+        }
+        return (*this)(rng::begin(r), rng::end(r), w, std::move(ofirst),
+                       std::move(op), std::move(proj));
+    }
+};
+
+} // detail
+
+inline constexpr auto moving_min = detail::moving_extremum_fn<false>{};
+
+inline constexpr auto moving_max = detail::moving_extremum_fn<true>{};
+
+inline constexpr auto moving_reduce = detail::moving_reduce_fn{};
+
+}}
+
+#endif
@@ -0,0 +1,376 @@
+// numeric_ranges/moving_sum.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_MOVING_SUM_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_MOVING_SUM_HPP_INCLUDED
+
+#include "core.hpp"
+#include "partial_sum.hpp"
+
+#ifndef TCB_NUMERIC_RANGES_USE_NANORANGE
+#include <algorithm>
+#endif
+
+#include <optional>
+
+namespace tcb {
+inline namespace ranges {
+
+template <typename I, typename O>
+using moving_sum_result = rng::copy_result<I, O>;
+
+namespace detail {
+
+// Computes the same recurrence as moving_sum_fn::impl, but split into two
+// passes over cache-sized blocks of the output: the differences between
+// the entering and leaving elements, which are independent and vectorise,
+// followed by an in-place partial_sum of those differences.
+template <typename T>
+void moving_sum_kernel(const T* in, std::ptrdiff_t n, std::ptrdiff_t w, T* out)
+{
+    constexpr std::ptrdiff_t block = 4096 / sizeof(T);
+    const std::ptrdiff_t m = n - w + 1;
+
+    T sum = in[0];
+    for (std::ptrdiff_t k = 1; k < w; ++k) {
+        sum = static_cast<T>(sum + in[k]);
+    }
+    out[0] = sum;
+
+    for (std::ptrdiff_t b = 1; b < m; b += block) {
+        const std::ptrdiff_t e = b + block < m ? b + block : m;
+        for (std::ptrdiff_t i = b; i < e; ++i) {
+            out[i] = static_cast<T>(in[i + w - 1] - in[i - 1]);
+        }
+        partial_sum_fn{}(out + b - 1, out + e, out + b - 1);
+    }
+}
+
+struct moving_sum_fn {
+private:
+    // Each output after the first is op(previous, inv_op(entering, leaving)),
+    // which needs only a second iterator trailing the first by w elements
+    template <typename I, typename S, typename O,
+              typename Op, typename InvOp, typename Proj>
+    static constexpr auto impl(I first, S last, _std::iter_difference_t<I> w,
+                               O ofirst, Op& op, InvOp& inv, Proj& proj)
+        -> moving_sum_result<I, O>
+    {
+        using V = _std::iter_value_t<I>;
+
+        if constexpr (is_contiguous_sized_v<I, S> &&
+                      _std::contiguous_iterator<O> &&
+                      std::is_same_v<_std::iter_value_t<O>, V> &&
+                      std::is_arithmetic_v<V> &&
+                      is_std_op_v<std::plus, Op, V> &&
+                      is_std_op_v<std::minus, InvOp, V> &&
+                      std::is_same_v<Proj, _std::identity>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = last - first;
+                const auto m = (w > 0 && n >= w) ? n - w + 1 : 0;
+                if (m > 0) {
+                    moving_sum_kernel(std::addressof(*first), n, w,
+                                      std::addressof(*ofirst));
+                }
+                return {first + n, ofirst + m};
+            }
+        }
+
+        if (w <= 0 || first == last) {
+            return {rng::next(std::move(first), last), std::move(ofirst)};
+        }
+
+        I trail = first;
+        auto sum = _std::invoke(proj, *first);
+
+        for (_std::iter_difference_t<I> k = 1; k < w; ++k) {
+            if (++first == last) {
+                return {std::move(first), std::move(ofirst)};
+            }
+            sum = _std::invoke(op, std::move(sum), _std::invoke(proj, *first));
+        }
+
+        *ofirst = sum;
+
+        while (++first != last) {
+            sum = _std::invoke(op, std::move(sum),
+                               _std::invoke(inv, _std::invoke(proj, *first),
+                                                 _std::invoke(proj, *trail)));
+            ++trail;
+            *++ofirst = sum;
+        }
+
+        ++ofirst;
+
+        return {std::move(first), std::move(ofirst)};
+    }
+
+public:
+    template <typename I, typename S, typename O,
+        typename Op = std::plus<>, typename InvOp = std::minus<>,
+        typename Proj = _std::identity>
+    constexpr auto operator()(I first, S last, _std::iter_difference_t<I> w,
+                              O ofirst, Op op = Op{}, InvOp inv = InvOp{},
+                              Proj proj = Proj{}) const
+    -> std::enable_if_t<
+        _std::forward_iterator<I> && _std::sentinel_for<S, I>,
+        moving_sum_result<I, O>>
+    {
+        return impl(std::move(first), std::move(last), w, std::move(ofirst),
+                    op, inv, proj);
+    }
+
+    template <typename R, typename O,
+        typename Op = std::plus<>, typename InvOp = std::minus<>,
+        typename Proj = _std::identity>
+    constexpr auto operator()(R&& r, rng::range_difference_t<R> w, O o,
+                              Op op = Op{}, InvOp inv = InvOp{},
+                              Proj proj = Proj{}) const
+    -> std::enable_if_t<
+        rng::forward_range<R>,
+        moving_sum_result<rng::borrowed_iterator_t<R>, O>>
+    {
+        return impl(rng::begin(r), rng::end(r), w, std::move(o), op, inv, proj);
+    }
+};
+
+// std::optional which is reset rather than copied when its owner is copied,
+// for views which cache the result of begin()
+template <typename T>
+struct non_propagating_cache : std::optional<T> {
+    non_propagating_cache() = default;
+    constexpr non_propagating_cache(const non_propagating_cache&) noexcept
+        : std::optional<T>()
+    {}
+    constexpr non_propagating_cache(non_propagating_cache&& other) noexcept
+        : std::optional<T>()
+    {
+        other.reset();
+    }
+    constexpr non_propagating_cache& operator=(const non_propagating_cache& other) noexcept
+    {
+        if (std::addressof(other) != this) {
+            this->reset();
+        }
+        return *this;
+    }
+    constexpr non_propagating_cache& operator=(non_propagating_cache&& other) noexcept
+    {
+        this->reset();
+        other.reset();
+        return *this;
+    }
+};
+
+} // detail
+
+// A view of the sums of each window of `window` consecutive elements of a
+// forward range, maintained incrementally as
+//     sum = op(sum, inv_op(entering, leaving))
+// so each step costs O(1) regardless of the window size. A range of n
+// elements yields max(0, n - window + 1) sums.
+template <typename V, typename Op = std::plus<>, typename InvOp = std::minus<>>
+class sliding_sum_view
+    : public rng::view_interface<sliding_sum_view<V, Op, InvOp>> {
+
+    using base_iterator = rng::iterator_t<V>;
+    using base_sentinel = rng::sentinel_t<V>;
+    using sum_type = rng::range_value_t<V>;
+    using difference_type_ = rng::range_difference_t<V>;
+
+public:
+    struct sentinel;
+
+    class iterator {
+        friend class sliding_sum_view;
+
+        sliding_sum_view* parent_ = nullptr;
+        base_iterator trail_{};
+        base_iterator lead_{};
+        base_sentinel end_{};
+        sum_type sum_{};
+
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+#ifdef TCB_NUMERIC_RANGES_USE_NANORANGE
+        // NanoRange determines the iterator concept from the category
+        using iterator_category = std::forward_iterator_tag;
+#else
+        using iterator_category = std::input_iterator_tag;
+#endif
+        using value_type = sum_type;
+        using difference_type = difference_type_;
+
+        iterator() = default;
+
+        constexpr value_type operator*() const { return sum_; }
+
+        constexpr iterator& operator++()
+        {
+            if (++lead_ != end_) {
+                sum_ = _std::invoke(parent_->op_, std::move(sum_),
+                                    _std::invoke(parent_->inv_, *lead_, *trail_));
+            }
+            ++trail_;
+            return *this;
+        }
+
+        constexpr iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator& lhs, const iterator& rhs)
+        {
+            return lhs.lead_ == rhs.lead_;
+        }
+
+        friend constexpr bool operator!=(const iterator& lhs, const iterator& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+        friend constexpr bool operator==(const iterator& i, const sentinel& s)
+        {
+            return i.lead_ == s.end_;
+        }
+
+        friend constexpr bool operator==(const sentinel& s, const iterator& i)
+        {
+            return i == s;
+        }
+
+        friend constexpr bool operator!=(const iterator& i, const sentinel& s)
+        {
+            return !(i == s);
+        }
+
+        friend constexpr bool operator!=(const sentinel& s, const iterator& i)
+        {
+            return !(i == s);
+        }
+    };
+
+    struct sentinel {
+        base_sentinel end_{};
+    };
+
+    sliding_sum_view() = default;
+
+    constexpr sliding_sum_view(V base, difference_type_ window,
+                               Op op = Op{}, InvOp inv = InvOp{})
+        : base_(std::move(base)), window_(window),
+          op_(std::move(op)), inv_(std::move(inv))
+    {}
+
+    constexpr V base() const { return base_; }
+
+    constexpr difference_type_ window() const { return window_; }
+
+    // Summing the first window is O(window), so the result is cached
+    constexpr iterator begin()
+    {
+        if (!cached_begin_) {
+            iterator it;
+            it.parent_ = this;
+            it.trail_ = rng::begin(base_);
+            it.lead_ = it.trail_;
+            it.end_ = rng::end(base_);
+
+            if (window_ <= 0) {
+                it.lead_ = rng::next(it.lead_, it.end_);
+            } else if (it.lead_ != it.end_) {
+                it.sum_ = *it.lead_;
+                for (difference_type_ k = 1; k < window_; ++k) {
+                    if (++it.lead_ == it.end_) {
+                        break;
+                    }
+                    it.sum_ = _std::invoke(op_, std::move(it.sum_), *it.lead_);
+                }
+            }
+
+            cached_begin_.emplace(std::move(it));
+        }
+
+        return *cached_begin_;
+    }
+
+    constexpr sentinel end() { return sentinel{rng::end(base_)}; }
+
+    template <typename VV = V, std::enable_if_t<rng::sized_range<VV>, int> = 0>
+    constexpr auto size()
+    {
+        const auto n = static_cast<difference_type_>(rng::size(base_));
+        return static_cast<decltype(rng::size(base_))>(
+            (window_ > 0 && n >= window_) ? n - window_ + 1 : 0);
+    }
+
+private:
+    V base_ = V();
+    difference_type_ window_ = 0;
+    Op op_{};
+    InvOp inv_{};
+    detail::non_propagating_cache<iterator> cached_begin_;
+};
+
+template <typename R, typename Op, typename InvOp>
+sliding_sum_view(R&&, rng::range_difference_t<R>, Op, InvOp)
+    -> sliding_sum_view<decltype(rng::views::all(std::declval<R>())), Op, InvOp>;
+
+namespace detail {
+
+template <typename Op, typename InvOp>
+struct sliding_sum_closure {
+    std::ptrdiff_t window;
+    Op op;
+    InvOp inv;
+
+    template <typename R>
+    friend constexpr auto operator|(R&& r, const sliding_sum_closure& c)
+    -> std::enable_if_t<rng::viewable_range<R> && rng::forward_range<R>,
+        sliding_sum_view<decltype(rng::views::all(std::declval<R>())), Op, InvOp>>
+    {
+        return sliding_sum_view(rng::views::all(std::forward<R>(r)),
+                                static_cast<rng::range_difference_t<R>>(c.window),
+                                c.op, c.inv);
+    }
+};
+
+struct sliding_sum_view_fn {
+
+    template <typename R, typename Op = std::plus<>, typename InvOp = std::minus<>>
+    constexpr auto operator()(R&& r, rng::range_difference_t<R> window,
+                              Op op = Op{}, InvOp inv = InvOp{}) const
+    -> std::enable_if_t<rng::viewable_range<R> && rng::forward_range<R>,
+        sliding_sum_view<decltype(rng::views::all(std::declval<R>())), Op, InvOp>>
+    {
+        return sliding_sum_view(rng::views::all(std::forward<R>(r)), window,
+                                std::move(op), std::move(inv));
+    }
+
+    template <typename Op = std::plus<>, typename InvOp = std::minus<>>
+    constexpr auto operator()(std::ptrdiff_t window,
+                              Op op = Op{}, InvOp inv = InvOp{}) const
+    {
+        return sliding_sum_closure<Op, InvOp>{window, std::move(op), std::move(inv)};
+    }
+};
+
+} // detail
+
+inline constexpr auto moving_sum = detail::moving_sum_fn{};
+
+namespace views {
+
+inline constexpr auto sliding_sum = detail::sliding_sum_view_fn{};
+
+}
+
+}}
+
+#endif
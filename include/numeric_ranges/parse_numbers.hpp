@@ -0,0 +1,384 @@
+// numeric_ranges/parse_numbers.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Block-buffered parsing of delimited numeric text. This header is not
+// included by numeric_ranges.hpp.
+
+#ifndef TCB_NUMERIC_RANGES_PARSE_NUMBERS_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_PARSE_NUMBERS_HPP_INCLUDED
+
+#include "core.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <system_error>
+
+#if __has_include(<unistd.h>)
+#include <cerrno>
+#include <unistd.h>
+#define TCB_NUMERIC_RANGES_HAVE_FD_SOURCE
+#endif
+
+namespace tcb {
+inline namespace ranges {
+
+namespace detail {
+
+// Reads blocks from a stream buffer with sgetn(), so that there is one
+// virtual call per block rather than one or more per value
+class streambuf_source {
+public:
+    explicit streambuf_source(std::istream& is) : buf_(is.rdbuf()) {}
+
+    // Returns the number of bytes read, or 0 at end of input
+    std::size_t read(char* dest, std::size_t count)
+    {
+        if (buf_ == nullptr) {
+            return 0;
+        }
+        const auto n = buf_->sgetn(dest, static_cast<std::streamsize>(count));
+        return n > 0 ? static_cast<std::size_t>(n) : 0;
+    }
+
+    bool failed() const noexcept { return false; }
+
+private:
+    std::streambuf* buf_;
+};
+
+#ifdef TCB_NUMERIC_RANGES_HAVE_FD_SOURCE
+
+class fd_source {
+public:
+    explicit fd_source(int fd) : fd_(fd) {}
+
+    // Returns the number of bytes read, or 0 at end of input or on error
+    std::size_t read(char* dest, std::size_t count)
+    {
+        for (;;) {
+            const auto n = ::read(fd_, dest, count);
+            if (n >= 0) {
+                return static_cast<std::size_t>(n);
+            }
+            if (errno != EINTR) {
+                failed_ = true;
+                return 0;
+            }
+        }
+    }
+
+    bool failed() const noexcept { return failed_; }
+
+private:
+    int fd_;
+    bool failed_ = false;
+};
+
+#endif // TCB_NUMERIC_RANGES_HAVE_FD_SOURCE
+
+constexpr bool is_digit(char c) noexcept
+{
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// Converts the eight ASCII digits at p to their value, most significant
+// first, in a handful of 64-bit multiplies rather than eight dependent
+// multiply-adds. Precondition: all eight bytes are digits.
+inline std::uint64_t parse_eight_digits(const char* p) noexcept
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    v -= 0x3030303030303030;
+    // Combine adjacent digits into pairs, then pairs into groups of four,
+    // then the two groups of four
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+    return v;
+}
+
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || \
+    defined(_MSC_VER)
+inline constexpr bool use_swar_digits = true;
+#else
+inline constexpr bool use_swar_digits = false;
+#endif
+
+// As std::from_chars for integers, but decimal numbers short enough that
+// they cannot overflow T are converted eight digits at a time
+template <typename T>
+std::from_chars_result parse_integer(const char* first, const char* last,
+                                     T& value) noexcept
+{
+    const char* p = first;
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+        if (p != last && *p == '-') {
+            negative = true;
+            ++p;
+        }
+    }
+
+    const char* const digits = p;
+    while (p != last && is_digit(*p)) {
+        ++p;
+    }
+    const auto n = p - digits;
+
+    if (n == 0 || n > std::numeric_limits<T>::digits10) {
+        return std::from_chars(first, last, value);
+    }
+
+    using U = std::make_unsigned_t<T>;
+    std::uint64_t acc = 0;
+    const char* d = digits;
+    if constexpr (use_swar_digits && std::numeric_limits<T>::digits10 >= 8) {
+        for (; p - d >= 8; d += 8) {
+            acc = acc * 100000000 + parse_eight_digits(d);
+        }
+    }
+    for (; d != p; ++d) {
+        acc = acc * 10 + static_cast<std::uint64_t>(*d - '0');
+    }
+
+    const auto u = static_cast<U>(acc);
+    value = negative ? static_cast<T>(U(0) - u) : static_cast<T>(u);
+    return {p, std::errc{}};
+}
+
+template <typename T>
+std::from_chars_result parse_number(const char* first, const char* last,
+                                    T& value) noexcept
+{
+    if constexpr (std::is_integral_v<T>) {
+        return parse_integer(first, last, value);
+    } else {
+        return std::from_chars(first, last, value);
+    }
+}
+
+} // namespace detail
+
+// A single-pass range of the numbers of type T in delimited text, such as
+// the contents of a CSV file or a newline-separated dump. Values are
+// separated by the delimiter or by line breaks, and may be surrounded by
+// spaces or tabs; empty fields are skipped.
+//
+// Input is read in large blocks and parsed with std::from_chars (with a
+// SWAR fast path for decimal integers), so iterating costs no virtual
+// calls or locale lookups per value. The source is read to its end, or
+// until the first value which cannot be parsed, at which point the range
+// ends and failed() returns true.
+template <typename T, typename Source>
+class parse_numbers_view {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                  "parse_numbers requires an arithmetic value type");
+
+public:
+    static constexpr std::size_t default_block_size = std::size_t{1} << 18;
+
+    struct sentinel {};
+
+    class iterator {
+        friend class parse_numbers_view;
+
+        parse_numbers_view* parent_ = nullptr;
+
+        explicit iterator(parse_numbers_view* parent) : parent_(parent) {}
+
+        bool at_end() const { return parent_->done_; }
+
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        const T& operator*() const { return parent_->value_; }
+
+        iterator& operator++()
+        {
+            parent_->next();
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& i, const sentinel&)
+        {
+            return i.at_end();
+        }
+
+        friend bool operator==(const sentinel& s, const iterator& i)
+        {
+            return i == s;
+        }
+
+        friend bool operator!=(const iterator& i, const sentinel& s)
+        {
+            return !(i == s);
+        }
+
+        friend bool operator!=(const sentinel& s, const iterator& i)
+        {
+            return !(i == s);
+        }
+    };
+
+    explicit parse_numbers_view(Source source, char delimiter = ',',
+                                std::size_t block_size = default_block_size)
+        : source_(std::move(source)),
+          buffer_(std::make_unique<char[]>(block_size > 0 ? block_size : 1)),
+          capacity_(block_size > 0 ? block_size : 1),
+          delim_(delimiter)
+    {}
+
+    parse_numbers_view(parse_numbers_view&&) = default;
+    parse_numbers_view& operator=(parse_numbers_view&&) = default;
+
+    // Parses the first value. As with std::ranges::istream_view, begin()
+    // may only be called once.
+    iterator begin()
+    {
+        next();
+        return iterator{this};
+    }
+
+    sentinel end() const noexcept { return {}; }
+
+    // True if parsing stopped at malformed input, or at a read error
+    bool failed() const noexcept { return failed_ || source_.failed(); }
+
+private:
+    bool is_blank(char c) const noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    bool is_terminator(char c) const noexcept
+    {
+        return c == delim_ || c == '\n';
+    }
+
+    // Moves any unparsed bytes to the front of the buffer and reads as much
+    // as will fit after them. Afterwards, every value which starts before
+    // limit_ ends before it too.
+    void refill()
+    {
+        const std::size_t kept = static_cast<std::size_t>(end_ - pos_);
+        if (kept == capacity_) {
+            // A single field fills the buffer
+            auto bigger = std::make_unique<char[]>(capacity_ * 2);
+            std::memcpy(bigger.get(), pos_, kept);
+            buffer_ = std::move(bigger);
+            capacity_ *= 2;
+        } else if (kept > 0) {
+            std::memmove(buffer_.get(), pos_, kept);
+        }
+        pos_ = buffer_.get();
+        end_ = pos_ + kept;
+
+        while (!eof_ && end_ != buffer_.get() + capacity_) {
+            const auto n = source_.read(end_, capacity_ - (end_ - buffer_.get()));
+            if (n == 0) {
+                eof_ = true;
+            }
+            end_ += n;
+        }
+
+        limit_ = end_;
+        if (!eof_) {
+            // A value in the final partial field may continue in the next
+            // block, so stop before it
+            while (limit_ != pos_ && !is_terminator(limit_[-1])) {
+                --limit_;
+            }
+        }
+    }
+
+    void next()
+    {
+        for (;;) {
+            while (pos_ != limit_ && (is_blank(*pos_) || is_terminator(*pos_))) {
+                ++pos_;
+            }
+
+            if (pos_ == limit_) {
+                if (eof_ && pos_ == end_) {
+                    done_ = true;
+                    return;
+                }
+                refill();
+                continue;
+            }
+
+            const auto res = detail::parse_number(pos_, limit_, value_);
+            if (res.ec != std::errc{} ||
+                (res.ptr != limit_ && !is_blank(*res.ptr) && !is_terminator(*res.ptr))) {
+                failed_ = true;
+                done_ = true;
+                return;
+            }
+            pos_ = const_cast<char*>(res.ptr);
+            return;
+        }
+    }
+
+    Source source_;
+    std::unique_ptr<char[]> buffer_;
+    std::size_t capacity_;
+    char* pos_ = buffer_.get();
+    char* limit_ = pos_;
+    char* end_ = pos_;
+    T value_{};
+    char delim_;
+    bool eof_ = false;
+    bool done_ = false;
+    bool failed_ = false;
+};
+
+namespace detail {
+
+template <typename T>
+struct parse_numbers_fn {
+    parse_numbers_view<T, streambuf_source>
+    operator()(std::istream& is, char delimiter = ',',
+               std::size_t block_size = parse_numbers_view<T, streambuf_source>::default_block_size) const
+    {
+        return parse_numbers_view<T, streambuf_source>(streambuf_source(is),
+                                                       delimiter, block_size);
+    }
+
+#ifdef TCB_NUMERIC_RANGES_HAVE_FD_SOURCE
+    parse_numbers_view<T, fd_source>
+    operator()(int fd, char delimiter = ',',
+               std::size_t block_size = parse_numbers_view<T, fd_source>::default_block_size) const
+    {
+        return parse_numbers_view<T, fd_source>(fd_source(fd), delimiter, block_size);
+    }
+#endif
+};
+
+} // namespace detail
+
+namespace views {
+
+// views::parse_numbers<T>(is, delimiter = ',') parses the rest of the
+// istream `is`; on POSIX systems, views::parse_numbers<T>(fd, delimiter)
+// parses the rest of the file descriptor `fd`, which the caller still owns
+template <typename T = double>
+inline constexpr auto parse_numbers = detail::parse_numbers_fn<T>{};
+
+}
+
+} // namespace ranges
+} // namespace tcb
+
+#endif
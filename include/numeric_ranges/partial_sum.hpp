@@ -0,0 +1,431 @@
+// numeric_ranges/partial_sum.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_PARTIAL_SUM_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_PARTIAL_SUM_HPP_INCLUDED
+
+#include "core.hpp"
+#include "dispatch.hpp"
+#include "saturating.hpp"
+#include "segmented.hpp"
+#include "streaming_store.hpp"
+
+#ifndef TCB_NUMERIC_RANGES_USE_NANORANGE
+#include <algorithm>
+#endif
+
+#include <limits>
+#include <optional>
+
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+#include <immintrin.h>
+#endif
+
+namespace tcb {
+inline namespace ranges {
+
+template <typename I, typename O>
+using partial_sum_result = rng::copy_result<I, O>;
+
+namespace detail {
+
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+// Prefix sums of 32- or 64-bit integers, one 256-bit register at a time:
+// shift-and-add steps within each 128-bit half, then the last element of
+// the low half is added to the high half, and finally the running total,
+// which starts at init and is re-broadcast from the last element. Each
+// block is loaded before it is stored, so out may be equal to in. With
+// Stream, out is written with non-temporal stores once it reaches a 32-byte
+// boundary.
+template <typename E, bool Stream = false>
+TCB_NUMERIC_RANGES_TARGET_AVX2
+void partial_sum_avx2(const E* in, E* out, std::ptrdiff_t n, E init = E{0})
+{
+    using U = std::make_unsigned_t<E>;
+    constexpr std::ptrdiff_t L = 32 / sizeof(E);
+
+    std::ptrdiff_t i = 0;
+    U head = static_cast<U>(init);
+    if constexpr (Stream) {
+        for (; i < n && reinterpret_cast<std::uintptr_t>(out + i) % 32 != 0; ++i) {
+            head += static_cast<U>(in[i]);
+            out[i] = static_cast<E>(head);
+        }
+    }
+
+    __m256i carry;
+    if constexpr (sizeof(E) == 4) {
+        carry = _mm256_set1_epi32(static_cast<int>(head));
+    } else {
+        carry = _mm256_set1_epi64x(static_cast<long long>(head));
+    }
+    for (; i + L <= n; i += L) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        if constexpr (sizeof(E) == 4) {
+            x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+            x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+            const __m256i low = _mm256_shuffle_epi32(x, 0xFF);
+            x = _mm256_add_epi32(x, _mm256_permute2x128_si256(low, low, 0x08));
+            x = _mm256_add_epi32(x, carry);
+            carry = _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7));
+        } else {
+            x = _mm256_add_epi64(x, _mm256_slli_si256(x, 8));
+            const __m256i low = _mm256_permute4x64_epi64(x, 0x55);
+            x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_setzero_si256(), low, 0xF0));
+            x = _mm256_add_epi64(x, carry);
+            carry = _mm256_permute4x64_epi64(x, 0xFF);
+        }
+        if constexpr (Stream) {
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(out + i), x);
+        } else {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), x);
+        }
+    }
+    if constexpr (Stream) {
+        _mm_sfence();
+    }
+
+    U sum = i > 0 ? static_cast<U>(out[i - 1]) : head;
+    for (; i < n; ++i) {
+        sum += static_cast<U>(in[i]);
+        out[i] = static_cast<E>(sum);
+    }
+}
+#endif
+
+// Running sums of 32- or 64-bit integers, starting from init, which carries
+// the sum of any earlier elements. Compilers do not vectorise the
+// loop-carried dependency themselves, so the vector tiers use
+// partial_sum_avx2; AVX-512 offers no cheaper cross-lane step for this, so
+// that tier uses it too.
+struct partial_sum_kernel {
+    template <simd_isa Isa, typename E>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static void run(const E* in, E* out, std::ptrdiff_t n, E init)
+    {
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+        if constexpr (Isa != simd_isa::scalar) {
+            partial_sum_avx2(in, out, n, init);
+            return;
+        }
+#endif
+        using U = std::make_unsigned_t<E>;
+        U sum = static_cast<U>(init);
+        for (std::ptrdiff_t i = 0; i < n; ++i) {
+            sum += static_cast<U>(in[i]);
+            out[i] = static_cast<E>(sum);
+        }
+    }
+};
+
+// As partial_sum_kernel, but writing out with non-temporal stores: directly
+// from the vector tiers, or through an L1-resident staging block otherwise
+struct partial_sum_stream_kernel {
+    template <simd_isa Isa, typename E>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static void run(const E* in, E* out, std::ptrdiff_t n)
+    {
+#if defined(TCB_NUMERIC_RANGES_DISPATCH)
+        if constexpr (Isa != simd_isa::scalar) {
+            partial_sum_avx2<E, true>(in, out, n);
+            return;
+        }
+#endif
+        using U = std::make_unsigned_t<E>;
+        U sum{0};
+        stream_blocks(out, n, [in, &sum](E* stage, std::ptrdiff_t i, std::ptrdiff_t m) {
+            for (std::ptrdiff_t j = 0; j < m; ++j) {
+                sum += static_cast<U>(in[i + j]);
+                stage[j] = static_cast<E>(sum);
+            }
+        });
+    }
+};
+
+// Running saturating sums of 8- or 16-bit integers. Each clamps the last,
+// so they cannot be computed in independent lanes; instead each block is
+// widened to 32 bits and scanned as an ordinary prefix sum, and if none of
+// those sums leaves the range of E, none would have been clamped and the
+// block is narrowed into out. Only blocks which do reach the bounds are
+// redone one element at a time. Each block is read before it is written,
+// so out may be equal to in.
+struct saturating_scan_kernel {
+    template <simd_isa Isa, typename E>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static void run(const E* in, E* out, std::ptrdiff_t n)
+    {
+        constexpr std::ptrdiff_t B = 256;
+        constexpr std::int32_t lo = (std::numeric_limits<E>::min)();
+        constexpr std::int32_t hi = (std::numeric_limits<E>::max)();
+
+        alignas(32) std::int32_t stage[B];
+        std::int32_t sum = 0;
+        std::ptrdiff_t i = 0;
+        for (; i + B <= n; i += B) {
+            for (std::ptrdiff_t j = 0; j < B; ++j) {
+                stage[j] = in[i + j];
+            }
+            // The length is B, but passed at run time: with a constant, GCC
+            // warns about the scan's (then unreachable) remainder loop
+            const std::ptrdiff_t m = n - i < B ? n - i : B;
+            partial_sum_kernel::run<Isa>(stage + 0, stage + 0, m, sum);
+
+            std::int32_t min = sum, max = sum;
+            for (std::ptrdiff_t j = 0; j < B; ++j) {
+                min = stage[j] < min ? stage[j] : min;
+                max = stage[j] > max ? stage[j] : max;
+            }
+            if (min >= lo && max <= hi) {
+                for (std::ptrdiff_t j = 0; j < B; ++j) {
+                    out[i + j] = static_cast<E>(stage[j]);
+                }
+                sum = stage[B - 1];
+            } else {
+                for (std::ptrdiff_t j = 0; j < B; ++j) {
+                    sum = saturating_add(static_cast<E>(sum), in[i + j]);
+                    out[i + j] = static_cast<E>(sum);
+                }
+            }
+        }
+        for (; i < n; ++i) {
+            sum = saturating_add(static_cast<E>(sum), in[i]);
+            out[i] = static_cast<E>(sum);
+        }
+    }
+};
+
+struct partial_sum_fn {
+private:
+    template <typename I, typename S, typename O, typename Op, typename Proj>
+    static constexpr auto impl(I first, S last, O ofirst, Op& op, Proj& proj)
+        -> partial_sum_result<I, O>
+    {
+        if constexpr (is_streaming_store_v<O>) {
+            return stream(std::move(first), std::move(last), ofirst, op, proj);
+        } else if constexpr (is_back_insert_iterator_v<O>) {
+            return append(std::move(first), std::move(last), std::move(ofirst), op, proj);
+        } else if constexpr (is_contiguous_sized_v<I, S> && _std::contiguous_iterator<O>) {
+            using E = _std::iter_value_t<I>;
+            if constexpr (std::is_same_v<_std::iter_value_t<O>, E> &&
+                          is_lane_integer_v<E> && (sizeof(E) == 4 || sizeof(E) == 8) &&
+                          is_std_op_v<std::plus, Op, E> &&
+                          std::is_same_v<Proj, _std::identity>) {
+                if (!detail::is_constant_evaluated()) {
+                    const auto n = static_cast<std::ptrdiff_t>(last - first);
+                    if (n > 0) {
+                        const E* in = std::addressof(*first);
+                        E* out = std::addressof(*ofirst);
+                        if (same_or_disjoint(in, out, n)) {
+                            dispatch<partial_sum_kernel>(in, out, n, E{0});
+                            return {first + n, ofirst + n};
+                        }
+                    }
+                }
+            } else if constexpr (std::is_same_v<_std::iter_value_t<O>, E> &&
+                                 is_narrow_integer_v<E> &&
+                                 is_std_op_v<saturating_plus, Op, E> &&
+                                 std::is_same_v<Proj, _std::identity>) {
+                if (!detail::is_constant_evaluated()) {
+                    const auto n = static_cast<std::ptrdiff_t>(last - first);
+                    if (n > 0) {
+                        const E* in = std::addressof(*first);
+                        E* out = std::addressof(*ofirst);
+                        if (same_or_disjoint(in, out, n)) {
+                            dispatch<saturating_scan_kernel>(in, out, n);
+                            return {first + n, ofirst + n};
+                        }
+                    }
+                }
+            }
+        } else if constexpr (is_segmented_v<I, S>) {
+            if (!detail::is_constant_evaluated()) {
+                auto out = scan_segments<_std::iter_value_t<I>>([&](auto f) {
+                    for_each_segment(first, last, f);
+                }, std::move(ofirst), op, proj);
+                return {std::move(last), std::move(out)};
+            }
+        }
+
+        return sequential(std::move(first), std::move(last), std::move(ofirst), op, proj);
+    }
+
+    template <typename I, typename S, typename O, typename Op, typename Proj>
+    static constexpr auto sequential(I first, S last, O ofirst, Op& op, Proj& proj)
+        -> partial_sum_result<I, O>
+    {
+        if (first == last) {
+            return {std::move(first), std::move(ofirst)};
+        }
+
+        auto sum = _std::invoke(proj, *first);
+        *ofirst = sum;
+
+        while (++first != last) {
+            accumulate_into(op, sum, _std::invoke(proj, *first));
+            *++ofirst = sum;
+        }
+
+        ++ofirst;
+
+        return {std::move(first), std::move(ofirst)};
+    }
+
+    template <typename I, typename S, typename E, typename Op, typename Proj>
+    static constexpr auto stream(I first, S last, streaming_store_iterator<E> ofirst,
+                                 Op& op, Proj& proj)
+        -> partial_sum_result<I, streaming_store_iterator<E>>
+    {
+        if constexpr (is_contiguous_sized_v<I, S> &&
+                      std::is_same_v<_std::iter_value_t<I>, E> &&
+                      std::is_arithmetic_v<E> && !std::is_same_v<E, bool> &&
+                      is_std_op_v<std::plus, Op, E> &&
+                      std::is_same_v<Proj, _std::identity>) {
+            const auto n = static_cast<std::ptrdiff_t>(last - first);
+            if (!detail::is_constant_evaluated() && n > 0 && ofirst.streams(n)) {
+                const E* in = std::addressof(*first);
+                if (same_or_disjoint(in, ofirst.base(), n)) {
+                    if constexpr (is_lane_integer_v<E> && (sizeof(E) == 4 || sizeof(E) == 8)) {
+                        dispatch<partial_sum_stream_kernel>(in, ofirst.base(), n);
+                    } else {
+                        E sum = in[0];
+                        stream_blocks(ofirst.base(), n,
+                                      [in, &sum](E* stage, std::ptrdiff_t i, std::ptrdiff_t m) {
+                            std::ptrdiff_t j = 0;
+                            if (i == 0) {
+                                stage[j++] = sum;
+                            }
+                            for (; j < m; ++j) {
+                                sum = static_cast<E>(sum + in[i + j]);
+                                stage[j] = sum;
+                            }
+                        });
+                    }
+                    return {first + n, ofirst + n};
+                }
+            }
+        }
+
+        auto res = impl(std::move(first), std::move(last), ofirst.base(), op, proj);
+        return {std::move(res.in), ofirst + (res.out - ofirst.base())};
+    }
+
+    // Scans a segmented input, each of whose segments walk visits, carrying
+    // the running sum from each segment into the next
+    template <typename E, typename Walk, typename O, typename Op, typename Proj>
+    static O scan_segments(Walk walk, O out, Op& op, Proj& proj)
+    {
+        if constexpr (_std::contiguous_iterator<O> &&
+                      std::is_same_v<_std::iter_value_t<O>, E> &&
+                      is_lane_integer_v<E> && (sizeof(E) == 4 || sizeof(E) == 8) &&
+                      is_std_op_v<std::plus, Op, E> &&
+                      std::is_same_v<Proj, _std::identity>) {
+            E carry{0};
+            walk([&](const E* p, const E* q) {
+                const auto n = q - p;
+                E* o = std::addressof(*out);
+                if (same_or_disjoint(p, o, n)) {
+                    dispatch<partial_sum_kernel>(p, o, n, carry);
+                } else {
+                    E sum = carry;
+                    for (std::ptrdiff_t i = 0; i < n; ++i) {
+                        sum = wrapping_add(sum, static_cast<std::uint64_t>(p[i]));
+                        o[i] = sum;
+                    }
+                }
+                carry = o[n - 1];
+                out += n;
+            });
+            return out;
+        } else {
+            using V = std::remove_cv_t<std::remove_reference_t<std::invoke_result_t<Proj&, E&>>>;
+            std::optional<V> sum;
+            walk([&](auto* p, auto* q) {
+                if (!sum) {
+                    sum.emplace(_std::invoke(proj, *p));
+                    *out = *sum;
+                    ++out;
+                    ++p;
+                }
+                for (; p != q; ++p) {
+                    accumulate_into(op, *sum, _std::invoke(proj, *p));
+                    *out = *sum;
+                    ++out;
+                }
+            });
+            return out;
+        }
+    }
+
+    // Appending to a container: make room for the output up front, and for
+    // vectors of arithmetic values write it through a pointer so that the
+    // contiguous fast path applies
+    template <typename I, typename S, typename C, typename Op, typename Proj>
+    static constexpr auto append(I first, S last, std::back_insert_iterator<C> ofirst,
+                                 Op& op, Proj& proj)
+        -> partial_sum_result<I, std::back_insert_iterator<C>>
+    {
+        if constexpr (_std::sized_sentinel_for<S, I>) {
+            if (!detail::is_constant_evaluated()) {
+                using R = std::invoke_result_t<Proj&, _std::iter_reference_t<I>>;
+                C& c = back_insert_container(ofirst);
+                const auto n = static_cast<std::size_t>(last - first);
+                if constexpr (is_resizable_contiguous_v<C> &&
+                              std::is_nothrow_invocable_v<Proj&, _std::iter_reference_t<I>> &&
+                              std::is_nothrow_invocable_v<Op&, R, R>) {
+                    const std::size_t old = c.size();
+                    c.resize(old + n);
+                    auto res = impl(std::move(first), std::move(last), c.data() + old, op, proj);
+                    return {std::move(res.in), std::move(ofirst)};
+                } else {
+                    reserve_more(c, n);
+                }
+            }
+        }
+
+        return sequential(std::move(first), std::move(last), std::move(ofirst), op, proj);
+    }
+
+public:
+    template <typename I, typename S, typename O,
+        typename Op = std::plus<>, typename Proj = _std::identity,
+        typename Id = std::decay_t<I>>
+    constexpr auto operator()(I&& first, S last, O ofirst,
+                              Op op = Op{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<
+        !rng::input_range<I> &&
+            _std::input_iterator<Id> && _std::sentinel_for<S, Id>,
+        partial_sum_result<Id, O>>
+    {
+        return impl(std::forward<I>(first), std::move(last), std::move(ofirst),
+                    op, proj);
+    };
+
+    template <typename R, typename O, typename Op = std::plus<>,
+        typename Proj = _std::identity>
+    constexpr auto operator()(R&& r, O o, Op op = Op{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<rng::input_range<R>,
+        partial_sum_result<rng::borrowed_iterator_t<R>, O>>
+    {
+        if constexpr (has_segmented_range_traits_v<std::remove_cv_t<std::remove_reference_t<R>>> &&
+                      !is_streaming_store_v<O>) {
+            if (!detail::is_constant_evaluated()) {
+                auto out = scan_segments<rng::range_value_t<R>>([&](auto f) {
+                    for_each_segment(r, f);
+                }, std::move(o), op, proj);
+                return {segmented_end(r), std::move(out)};
+            }
+        }
+        return impl(rng::begin(r), rng::end(r), std::move(o), op, proj);
+    };
+};
+
+} // detail
+
+inline constexpr auto partial_sum = detail::partial_sum_fn{};
+
+}}
+
+#endif
@@ -0,0 +1,273 @@
+// numeric_ranges/prefetch.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_PREFETCH_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_PREFETCH_HPP_INCLUDED
+
+#include "core.hpp"
+
+#include <optional>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace tcb {
+inline namespace ranges {
+
+namespace detail {
+
+inline void prefetch_read(const void* addr) noexcept
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(addr, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(addr), _MM_HINT_T0);
+#else
+    (void) addr;
+#endif
+}
+
+// Holds a function object, making it assignable even if it is not (as with
+// lambdas with captures), so that views storing one remain views
+template <typename T>
+class movable_box {
+public:
+    movable_box()
+    {
+        if constexpr (std::is_default_constructible_v<T>) {
+            opt_.emplace();
+        }
+    }
+
+    constexpr explicit movable_box(T t) : opt_(std::move(t)) {}
+
+    movable_box(const movable_box&) = default;
+    movable_box(movable_box&&) = default;
+
+    movable_box& operator=(const movable_box& other)
+    {
+        if (this != &other) {
+            if (other.opt_) {
+                opt_.emplace(*other.opt_);
+            } else {
+                opt_.reset();
+            }
+        }
+        return *this;
+    }
+
+    movable_box& operator=(movable_box&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != &other) {
+            if (other.opt_) {
+                opt_.emplace(std::move(*other.opt_));
+            } else {
+                opt_.reset();
+            }
+        }
+        return *this;
+    }
+
+    constexpr const T& operator*() const { return *opt_; }
+
+private:
+    std::optional<T> opt_;
+};
+
+// The default address function: the address of the element itself
+struct addressof_fn {
+    template <typename T>
+    constexpr const void* operator()(T& t) const noexcept
+    {
+        return std::addressof(t);
+    }
+};
+
+} // namespace detail
+
+// A view of the elements of a random-access range which, as each element is
+// stepped past, prefetches the memory for the element `distance` positions
+// ahead, so that by the time a reduction reaches it the load is already in
+// flight. The address prefetched is addr(*(it + distance)): by default the
+// address of the element itself, which suits strided or permuted views of
+// lvalues. For gathers through an index range, prefetch the indexed
+// element instead and apply the lookup afterwards, e.g.
+//
+//     idx | views::prefetch(16, [&](auto i) { return &table[i]; })
+//         | views::transform([&](auto i) { return table[i]; })
+//
+// Reading idx ahead is cheap, since it is sequential; the loads this hides
+// are the random ones into table.
+template <typename V, typename Addr = detail::addressof_fn>
+class prefetch_view : public rng::view_interface<prefetch_view<V, Addr>> {
+
+    using base_iterator = rng::iterator_t<V>;
+    using difference_type_ = rng::range_difference_t<V>;
+
+public:
+    struct sentinel;
+
+    class iterator {
+        friend class prefetch_view;
+
+        const prefetch_view* parent_ = nullptr;
+        base_iterator current_{};
+        // The last position from which there is an element `distance` ahead
+        base_iterator stop_{};
+
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+#ifdef TCB_NUMERIC_RANGES_USE_NANORANGE
+        using iterator_category = std::forward_iterator_tag;
+#else
+        using iterator_category = std::input_iterator_tag;
+#endif
+        using value_type = rng::range_value_t<V>;
+        using difference_type = difference_type_;
+
+        iterator() = default;
+
+        constexpr decltype(auto) operator*() const { return *current_; }
+
+        constexpr iterator& operator++()
+        {
+            if (current_ < stop_ && !detail::is_constant_evaluated()) {
+                detail::prefetch_read(_std::invoke(*parent_->addr_,
+                                                   current_[parent_->distance_]));
+            }
+            ++current_;
+            return *this;
+        }
+
+        constexpr iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        constexpr base_iterator base() const { return current_; }
+
+        friend constexpr bool operator==(const iterator& lhs, const iterator& rhs)
+        {
+            return lhs.current_ == rhs.current_;
+        }
+
+        friend constexpr bool operator!=(const iterator& lhs, const iterator& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+        friend constexpr bool operator==(const iterator& i, const sentinel& s)
+        {
+            return i.current_ == s.end_;
+        }
+
+        friend constexpr bool operator==(const sentinel& s, const iterator& i)
+        {
+            return i == s;
+        }
+
+        friend constexpr bool operator!=(const iterator& i, const sentinel& s)
+        {
+            return !(i == s);
+        }
+
+        friend constexpr bool operator!=(const sentinel& s, const iterator& i)
+        {
+            return !(i == s);
+        }
+    };
+
+    struct sentinel {
+        rng::sentinel_t<V> end_{};
+    };
+
+    prefetch_view() = default;
+
+    constexpr prefetch_view(V base, difference_type_ distance, Addr addr = Addr{})
+        : base_(std::move(base)), distance_(distance), addr_(std::move(addr))
+    {}
+
+    constexpr V base() const { return base_; }
+
+    constexpr difference_type_ distance() const { return distance_; }
+
+    constexpr iterator begin()
+    {
+        iterator it;
+        it.parent_ = this;
+        it.current_ = rng::begin(base_);
+        const auto n = static_cast<difference_type_>(rng::distance(base_));
+        it.stop_ = it.current_ + (distance_ > 0 && n > distance_ ? n - distance_ : 0);
+        return it;
+    }
+
+    constexpr sentinel end() { return sentinel{rng::end(base_)}; }
+
+    constexpr auto size() { return rng::size(base_); }
+
+private:
+    V base_ = V();
+    difference_type_ distance_ = 0;
+    detail::movable_box<Addr> addr_{};
+};
+
+template <typename R, typename Addr>
+prefetch_view(R&&, rng::range_difference_t<R>, Addr)
+    -> prefetch_view<decltype(rng::views::all(std::declval<R>())), Addr>;
+
+namespace detail {
+
+template <typename Addr>
+struct prefetch_closure {
+    std::ptrdiff_t distance;
+    Addr addr;
+
+    template <typename R>
+    friend constexpr auto operator|(R&& r, const prefetch_closure& c)
+    -> std::enable_if_t<rng::viewable_range<R> && rng::random_access_range<R> &&
+                        rng::sized_range<R>,
+        prefetch_view<decltype(rng::views::all(std::declval<R>())), Addr>>
+    {
+        return prefetch_view(rng::views::all(std::forward<R>(r)),
+                             static_cast<rng::range_difference_t<R>>(c.distance),
+                             c.addr);
+    }
+};
+
+struct prefetch_view_fn {
+
+    template <typename R, typename Addr = addressof_fn>
+    constexpr auto operator()(R&& r, rng::range_difference_t<R> distance,
+                              Addr addr = Addr{}) const
+    -> std::enable_if_t<rng::viewable_range<R> && rng::random_access_range<R> &&
+                        rng::sized_range<R>,
+        prefetch_view<decltype(rng::views::all(std::declval<R>())), Addr>>
+    {
+        return prefetch_view(rng::views::all(std::forward<R>(r)), distance,
+                             std::move(addr));
+    }
+
+    template <typename Addr = addressof_fn>
+    constexpr auto operator()(std::ptrdiff_t distance, Addr addr = Addr{}) const
+    {
+        return prefetch_closure<Addr>{distance, std::move(addr)};
+    }
+};
+
+} // detail
+
+namespace views {
+
+inline constexpr auto prefetch = detail::prefetch_view_fn{};
+
+}
+
+}}
+
+#endif
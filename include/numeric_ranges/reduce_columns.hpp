@@ -0,0 +1,105 @@
+// numeric_ranges/reduce_columns.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_REDUCE_COLUMNS_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_REDUCE_COLUMNS_HPP_INCLUDED
+
+#include "accumulate.hpp"
+#include "core.hpp"
+#include "dispatch.hpp"
+#include "strided_span.hpp"
+
+namespace tcb {
+inline namespace ranges {
+
+namespace detail {
+
+// Adds each of rows rows, row_stride elements apart, into the w column
+// sums in acc. The inner loop runs along a row, so it vectorises across
+// columns, and each column is still summed in row order.
+template <typename A>
+struct column_sum_kernel {
+    template <simd_isa, typename E>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static void run(const E* data, std::ptrdiff_t row_stride, std::ptrdiff_t rows,
+                    A* acc, std::ptrdiff_t w)
+    {
+        for (std::ptrdiff_t i = 0; i < rows; ++i) {
+            const E* row = data + i * row_stride;
+            for (std::ptrdiff_t j = 0; j < w; ++j) {
+                acc[j] += static_cast<A>(row[j]);
+            }
+        }
+    }
+};
+
+struct reduce_columns_fn {
+    template <typename T, typename O,
+        typename U = std::remove_cv_t<T>,
+        typename Op = std::plus<>,
+        typename Proj = _std::identity>
+    constexpr O operator()(matrix_view<T> m, O out, U init = U{},
+                           Op op = Op{}, Proj proj = Proj{}) const
+    {
+        using E = std::remove_cv_t<T>;
+
+        // The kernel converts each element to the sum's type before adding
+        // it, which is what accumulate does except for floating-point
+        // elements added to an integer (truncated) or to a narrower
+        // floating-point sum (rounded twice)
+        if constexpr (is_lane_summable_v<true, E, U> &&
+                      !(std::is_floating_point_v<E> && sizeof(E) > sizeof(U)) &&
+                      is_std_op_v<std::plus, Op, U> &&
+                      std::is_same_v<Proj, _std::identity>) {
+            if (!detail::is_constant_evaluated()) {
+                // Columns are taken a block at a time, so that their sums
+                // stay in L1 while the rows stream past
+                using A = lane_accumulator_t<U>;
+                constexpr std::ptrdiff_t block = 4096 / sizeof(A);
+                const auto rows = static_cast<std::ptrdiff_t>(m.rows());
+                const auto cols = static_cast<std::ptrdiff_t>(m.cols());
+                A acc[block];
+                for (std::ptrdiff_t j = 0; j < cols; j += block) {
+                    const std::ptrdiff_t w = cols - j < block ? cols - j : block;
+                    for (std::ptrdiff_t k = 0; k < w; ++k) {
+                        acc[k] = static_cast<A>(init);
+                    }
+                    if (rows > 0) {
+                        const E* data = m.data() + j;
+                        dispatch<column_sum_kernel<A>>(data, m.row_stride(), rows, acc + 0, w);
+                    }
+                    for (std::ptrdiff_t k = 0; k < w; ++k) {
+                        *out = static_cast<U>(acc[k]);
+                        ++out;
+                    }
+                }
+                return out;
+            }
+        }
+
+        for (std::size_t j = 0; j < m.cols(); ++j) {
+            *out = accumulate_fn{}(m.column(j), init, op, proj);
+            ++out;
+        }
+        return out;
+    }
+};
+
+} // namespace detail
+
+// reduce_columns(m, out, init, op, proj) writes to out the reduction of
+// each column of the row-major matrix m in turn, as if by
+// accumulate(m.column(j), init, op, proj), and returns the end of the
+// output. For arithmetic values summed with the default operation, the
+// matrix is read along its rows, updating a block of column sums in
+// parallel, rather than down each column with a stride; each column is
+// still summed in order, so floating-point results are the same as
+// accumulate's.
+inline constexpr auto reduce_columns = detail::reduce_columns_fn{};
+
+}}
+
+#endif
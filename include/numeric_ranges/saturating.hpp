@@ -0,0 +1,133 @@
+// numeric_ranges/saturating.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_SATURATING_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_SATURATING_HPP_INCLUDED
+
+#include "core.hpp"
+
+#include <limits>
+
+namespace tcb {
+inline namespace ranges {
+
+namespace detail {
+
+// x + y (or, with Minus, x - y), clamped to the range of T. Narrow types
+// are computed in int and clamped, which is the shape compilers lower to
+// saturating vector instructions; wider ones wrap and check the signs.
+template <bool Minus, typename T>
+constexpr T saturate(T x, T y)
+{
+    constexpr T lo = (std::numeric_limits<T>::min)();
+    constexpr T hi = (std::numeric_limits<T>::max)();
+
+    if constexpr (sizeof(T) < sizeof(int)) {
+        const int r = Minus ? int(x) - int(y) : int(x) + int(y);
+        return static_cast<T>(r < int(lo) ? int(lo) : r > int(hi) ? int(hi) : r);
+    } else if constexpr (std::is_unsigned_v<T>) {
+        if constexpr (Minus) {
+            return x < y ? lo : static_cast<T>(x - y);
+        } else {
+            const T r = static_cast<T>(x + y);
+            return r < x ? hi : r;
+        }
+    } else {
+        using U = std::make_unsigned_t<T>;
+        const T r = static_cast<T>(Minus ? U(U(x) - U(y)) : U(U(x) + U(y)));
+        // Overflow if the operands' signs (y's negated, for Minus) agree
+        // and the result's sign does not
+        const bool overflow = Minus ? ((x ^ y) & (x ^ r)) < 0 : (~(x ^ y) & (x ^ r)) < 0;
+        return overflow ? (x < 0 ? lo : hi) : r;
+    }
+}
+
+template <typename T>
+constexpr T saturating_add(T x, T y)
+{
+    return saturate<false>(x, y);
+}
+
+template <typename T>
+constexpr T saturating_sub(T x, T y)
+{
+    return saturate<true>(x, y);
+}
+
+} // namespace detail
+
+// Function objects for integer addition and subtraction which clamp the
+// result to the range of the type, rather than wrapping: 100 + 100 is 127
+// as an int8_t, and 3 - 5 is 0 as an unsigned. Like std::plus<>, the void
+// specialisations accept any two integers, converting them to their
+// common type.
+//
+// accumulate, reduce, partial_sum and adjacent_difference recognise these
+// for contiguous ranges of 8- and 16-bit integers. adjacent_difference
+// computes each element independently, so its loop vectorises into
+// paddsw / psubusb and the like. A saturating sum is not associative, so
+// it cannot be split across lanes; instead the others check cheaply (with
+// vector instructions) whether a block of elements could saturate at all,
+// and if not add it as an ordinary sum, only falling back to clamping
+// element by element for blocks which might saturate.
+template <typename T = void>
+struct saturating_plus {
+    constexpr T operator()(const T& x, const T& y) const
+    {
+        return detail::saturating_add(x, y);
+    }
+};
+
+template <>
+struct saturating_plus<void> {
+    template <typename T, typename U>
+    constexpr auto operator()(T x, U y) const
+    -> std::enable_if_t<detail::is_lane_integer_v<T> && detail::is_lane_integer_v<U>,
+        std::common_type_t<T, U>>
+    {
+        using C = std::common_type_t<T, U>;
+        return detail::saturating_add(static_cast<C>(x), static_cast<C>(y));
+    }
+
+    using is_transparent = void;
+};
+
+template <typename T = void>
+struct saturating_minus {
+    constexpr T operator()(const T& x, const T& y) const
+    {
+        return detail::saturating_sub(x, y);
+    }
+};
+
+template <>
+struct saturating_minus<void> {
+    template <typename T, typename U>
+    constexpr auto operator()(T x, U y) const
+    -> std::enable_if_t<detail::is_lane_integer_v<T> && detail::is_lane_integer_v<U>,
+        std::common_type_t<T, U>>
+    {
+        using C = std::common_type_t<T, U>;
+        return detail::saturating_sub(static_cast<C>(x), static_cast<C>(y));
+    }
+
+    using is_transparent = void;
+};
+
+namespace detail {
+
+// True for saturating_plus or saturating_minus on narrow integers, which
+// the contiguous fast paths handle
+template <typename Op, typename E>
+inline constexpr bool is_saturating_op_v =
+    is_narrow_integer_v<E> &&
+    (is_std_op_v<saturating_plus, Op, E> || is_std_op_v<saturating_minus, Op, E>);
+
+} // namespace detail
+
+}}
+
+#endif
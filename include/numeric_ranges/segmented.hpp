@@ -0,0 +1,169 @@
+// numeric_ranges/segmented.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_SEGMENTED_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_SEGMENTED_HPP_INCLUDED
+
+#include "core.hpp"
+
+#include <deque>
+
+namespace tcb {
+inline namespace ranges {
+
+namespace detail {
+
+// The base of the unspecialised traits
+struct not_segmented {};
+
+}
+
+// Customization points for sequences stored as a series of contiguous
+// blocks, such as std::deque or a join of vectors. Stepping an iterator of
+// such a sequence must check for the end of each block, which costs a
+// branch per element and keeps the compiler from vectorising; given the
+// blocks themselves, accumulate, reduce, inner_product, transform_reduce,
+// iota, partial_sum and adjacent_difference instead run their contiguous
+// loops (and SIMD kernels) over each block in turn.
+//
+// segmented_iterator_traits<I> describes an iterator type whose ranges
+// [first, last) are segmented; segmented_range_traits<R> describes a range
+// type R whose segments can only be found from the range as a whole. A
+// specialisation provides
+//
+//     template <typename F>
+//     static void for_each_segment(I first, I last, F&& f);
+//
+// or, for a range,
+//
+//     template <typename F>
+//     static void for_each_segment(const R& r, F&& f);
+//
+// which calls f(p, q) for each non-empty block of the sequence in order,
+// where p and q are pointers delimiting the block's elements.
+//
+// std::deque's iterators (with libstdc++) and join_view of contiguous
+// sized ranges over a borrowed base, such as a ref_view, are supported.
+template <typename I, typename = void>
+struct segmented_iterator_traits : detail::not_segmented {};
+
+template <typename R, typename = void>
+struct segmented_range_traits : detail::not_segmented {};
+
+namespace detail {
+
+template <typename I>
+inline constexpr bool has_segmented_iterator_traits_v =
+    !std::is_base_of_v<not_segmented, segmented_iterator_traits<I>>;
+
+template <typename R>
+inline constexpr bool has_segmented_range_traits_v =
+    !std::is_base_of_v<not_segmented, segmented_range_traits<R>>;
+
+// True if [first, last) can be visited a segment at a time
+template <typename I, typename S>
+inline constexpr bool is_segmented_v =
+    std::is_same_v<I, S> && has_segmented_iterator_traits_v<I>;
+
+// True if r can be visited a segment at a time
+template <typename R>
+inline constexpr bool is_segmented_range_v =
+    has_segmented_range_traits_v<std::remove_cv_t<std::remove_reference_t<R>>> ||
+    is_segmented_v<rng::iterator_t<R>, rng::sentinel_t<R>>;
+
+template <typename I, typename F>
+constexpr void for_each_segment(I first, I last, F&& f)
+{
+    segmented_iterator_traits<I>::for_each_segment(std::move(first), std::move(last), f);
+}
+
+template <typename R, typename F>
+constexpr void for_each_segment(R& r, F&& f)
+{
+    using Rd = std::remove_cv_t<R>;
+    if constexpr (has_segmented_range_traits_v<Rd>) {
+        segmented_range_traits<Rd>::for_each_segment(r, f);
+    } else {
+        for_each_segment(rng::begin(r), rng::end(r), f);
+    }
+}
+
+// The end iterator of a range, as returned by an algorithm which visited it
+// a segment at a time
+template <typename R>
+constexpr auto segmented_end(R& r)
+{
+    if constexpr (rng::common_range<R>) {
+        return rng::end(r);
+    } else {
+        return rng::next(rng::begin(r), rng::end(r));
+    }
+}
+
+} // namespace detail
+
+#if defined(__GLIBCXX__)
+// libstdc++'s deque iterators expose their position within the block map.
+// The standard offers no way to find the bounds of a deque's blocks, so
+// this reads the iterator's (undocumented) _M_cur, _M_first, _M_last and
+// _M_node members, and depends on libstdc++'s layout of them; with other
+// standard libraries, deques are visited with their iterators. If these
+// members change, test/segmented.cpp fails to compile or detects it.
+template <typename T, typename Ref, typename Ptr>
+struct segmented_iterator_traits<std::_Deque_iterator<T, Ref, Ptr>,
+    std::enable_if_t<std::is_pointer_v<Ptr>>> {
+
+    template <typename F>
+    static void for_each_segment(std::_Deque_iterator<T, Ref, Ptr> first,
+                                 std::_Deque_iterator<T, Ref, Ptr> last, F&& f)
+    {
+        if (first._M_node == last._M_node) {
+            if (first._M_cur != last._M_cur) {
+                f(Ptr(first._M_cur), Ptr(last._M_cur));
+            }
+            return;
+        }
+
+        f(Ptr(first._M_cur), Ptr(first._M_last));
+        const auto block = first._M_last - first._M_first;
+        for (auto node = first._M_node + 1; node != last._M_node; ++node) {
+            f(Ptr(*node), Ptr(*node + block));
+        }
+        if (last._M_first != last._M_cur) {
+            f(Ptr(last._M_first), Ptr(last._M_cur));
+        }
+    }
+};
+#endif
+
+#ifndef TCB_NUMERIC_RANGES_USE_NANORANGE
+// join_view::base() returns a copy of V, so only borrowed bases (such as
+// ref_view) are walked this way: their copies refer to the same blocks
+template <typename V>
+struct segmented_range_traits<rng::join_view<V>,
+    std::enable_if_t<rng::contiguous_range<rng::range_reference_t<V>> &&
+                     rng::sized_range<rng::range_reference_t<V>> &&
+                     std::is_lvalue_reference_v<rng::range_reference_t<V>> &&
+                     rng::borrowed_range<V> &&
+                     std::is_copy_constructible_v<V>>> {
+
+    template <typename F>
+    static constexpr void for_each_segment(const rng::join_view<V>& r, F&& f)
+    {
+        for (auto&& inner : r.base()) {
+            const auto n = rng::size(inner);
+            if (n != 0) {
+                auto* p = rng::data(inner);
+                f(p, p + n);
+            }
+        }
+    }
+};
+#endif
+
+}}
+
+#endif
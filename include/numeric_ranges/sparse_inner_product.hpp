@@ -0,0 +1,231 @@
+// numeric_ranges/sparse_inner_product.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_SPARSE_INNER_PRODUCT_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_SPARSE_INNER_PRODUCT_HPP_INCLUDED
+
+#include "core.hpp"
+#include "dispatch.hpp"
+
+namespace tcb {
+inline namespace ranges {
+
+namespace detail {
+
+// Default index and value projections for sparse vectors stored as
+// (index, value) pairs or tuples
+template <std::size_t N>
+struct get_fn {
+    template <typename T>
+    constexpr decltype(auto) operator()(T&& t) const
+    {
+        using std::get;
+        return get<N>(std::forward<T>(t));
+    }
+};
+
+// Sparse-dense dot product over kernel_lanes<A> independent accumulators.
+// The dense loads are independent of one another, so the AVX2 and AVX-512
+// tiers turn each block into vector gathers; in the scalar tier the separate
+// chains still let the loads overlap. As in dot_kernel, each product is
+// formed in P, the type op2 forms it in.
+template <typename T, typename P>
+struct sparse_gather_kernel {
+    template <simd_isa, typename E, typename D, typename IProj, typename VProj>
+    TCB_NUMERIC_RANGES_ALWAYS_INLINE
+    static T run(const E* sparse, std::ptrdiff_t n, const D* dense, T init,
+                 IProj iproj, VProj vproj)
+    {
+        using A = lane_accumulator_t<T>;
+        constexpr std::ptrdiff_t L = kernel_lanes<A>;
+
+        A acc[L] = {};
+        std::ptrdiff_t i = 0;
+        for (; i + L <= n; i += L) {
+            for (std::ptrdiff_t j = 0; j < L; ++j) {
+                const E& e = sparse[i + j];
+                acc[j] += static_cast<A>(multiply_as<P>(_std::invoke(vproj, e),
+                                                        dense[_std::invoke(iproj, e)]));
+            }
+        }
+
+        A sum = static_cast<A>(init);
+        for (std::ptrdiff_t j = 0; j < L; ++j) {
+            sum += acc[j];
+        }
+        for (; i < n; ++i) {
+            const E& e = sparse[i];
+            sum += static_cast<A>(multiply_as<P>(_std::invoke(vproj, e),
+                                                 dense[_std::invoke(iproj, e)]));
+        }
+        return static_cast<T>(sum);
+    }
+};
+
+struct sparse_inner_product_fn {
+    template <typename I, typename S, typename D, typename T,
+        typename Op1 = std::plus<>,
+        typename Op2 = std::multiplies<>,
+        typename IndexProj = get_fn<0>,
+        typename ValueProj = get_fn<1>,
+        typename DenseProj = _std::identity>
+    constexpr auto operator()(I first, S last, D dense, T init,
+                              Op1 op1 = Op1{}, Op2 op2 = Op2{},
+                              IndexProj iproj = IndexProj{},
+                              ValueProj vproj = ValueProj{},
+                              DenseProj dproj = DenseProj{}) const
+    -> std::enable_if_t<
+        _std::input_iterator<I> && _std::sentinel_for<S, I> &&
+            _std::random_access_iterator<D>,
+        T>
+    {
+        using Idx = projected_value_t<IndexProj, I>;
+        using Val = projected_value_t<ValueProj, I>;
+        using DV = _std::iter_value_t<D>;
+
+        if constexpr (is_contiguous_sized_v<I, S> &&
+                      _std::contiguous_iterator<D> &&
+                      std::is_integral_v<Idx> &&
+                      // an integer init needs integer values, which the
+                      // lanes sum modulo 2^N, rather than truncating each
+                      // floating-point value
+                      is_lane_summable_v<true, Val, T> &&
+                      is_lane_summable_v<true, DV, T> &&
+                      (std::is_floating_point_v<T> || is_wide_integer_v<T>) &&
+                      is_std_op_v<std::plus, Op1, T> &&
+                      is_std_op_v<std::multiplies, Op2, T> &&
+                      std::is_same_v<DenseProj, _std::identity>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = static_cast<std::ptrdiff_t>(last - first);
+                if (n == 0) {
+                    return init;
+                }
+                const auto* sparse = std::addressof(*first);
+                const auto* dense_data = std::addressof(*dense);
+                return dispatch<sparse_gather_kernel<T, product_t<Op2, Val, DV>>>(
+                    sparse, n, dense_data, std::move(init), iproj, vproj);
+            }
+        }
+
+        for (; first != last; ++first) {
+            auto&& e = *first;
+            init = _std::invoke(op1, std::move(init),
+                          _std::invoke(op2, _std::invoke(vproj, e),
+                                       _std::invoke(dproj, dense[_std::invoke(iproj, e)])));
+        }
+
+        return init;
+    }
+
+    template <typename R, typename DR, typename T,
+        typename Op1 = std::plus<>,
+        typename Op2 = std::multiplies<>,
+        typename IndexProj = get_fn<0>,
+        typename ValueProj = get_fn<1>,
+        typename DenseProj = _std::identity>
+    constexpr auto operator()(R&& sparse, DR&& dense, T init,
+                              Op1 op1 = Op1{}, Op2 op2 = Op2{},
+                              IndexProj iproj = IndexProj{},
+                              ValueProj vproj = ValueProj{},
+                              DenseProj dproj = DenseProj{}) const
+    -> std::enable_if_t<rng::input_range<R> && rng::random_access_range<DR>,
+        T>
+    {
+        return (*this)(rng::begin(sparse), rng::end(sparse), rng::begin(dense),
+                       std::move(init), std::move(op1), std::move(op2),
+                       std::move(iproj), std::move(vproj), std::move(dproj));
+    }
+};
+
+struct sparse_sparse_inner_product_fn {
+    template <typename I1, typename S1, typename I2, typename S2, typename T,
+        typename Op1 = std::plus<>,
+        typename Op2 = std::multiplies<>,
+        typename IndexProj = get_fn<0>,
+        typename ValueProj = get_fn<1>>
+    constexpr auto operator()(I1 first1, S1 last1, I2 first2, S2 last2, T init,
+                              Op1 op1 = Op1{}, Op2 op2 = Op2{},
+                              IndexProj iproj = IndexProj{},
+                              ValueProj vproj = ValueProj{}) const
+    -> std::enable_if_t<
+        _std::input_iterator<I1> && _std::sentinel_for<S1, I1> &&
+            _std::input_iterator<I2> && _std::sentinel_for<S2, I2>,
+        T>
+    {
+        if constexpr (_std::random_access_iterator<I1> &&
+                      _std::random_access_iterator<I2>) {
+            // Advance both sides without branching on which index is
+            // smaller, since that comparison is close to random for typical
+            // sparse data; only matches take a (rarely mispredicted) branch
+            while (first1 != last1 && first2 != last2) {
+                auto&& e1 = *first1;
+                auto&& e2 = *first2;
+                const auto i1 = _std::invoke(iproj, e1);
+                const auto i2 = _std::invoke(iproj, e2);
+                if (!(i1 < i2) && !(i2 < i1)) {
+                    init = _std::invoke(op1, std::move(init),
+                                  _std::invoke(op2, _std::invoke(vproj, e1),
+                                                    _std::invoke(vproj, e2)));
+                }
+                first1 += static_cast<_std::iter_difference_t<I1>>(!(i2 < i1));
+                first2 += static_cast<_std::iter_difference_t<I2>>(!(i1 < i2));
+            }
+        } else {
+            while (first1 != last1 && first2 != last2) {
+                auto&& e1 = *first1;
+                auto&& e2 = *first2;
+                const auto i1 = _std::invoke(iproj, e1);
+                const auto i2 = _std::invoke(iproj, e2);
+                if (i1 < i2) {
+                    ++first1;
+                } else if (i2 < i1) {
+                    ++first2;
+                } else {
+                    init = _std::invoke(op1, std::move(init),
+                                  _std::invoke(op2, _std::invoke(vproj, e1),
+                                                    _std::invoke(vproj, e2)));
+                    ++first1;
+                    ++first2;
+                }
+            }
+        }
+
+        return init;
+    }
+
+    template <typename R1, typename R2, typename T,
+        typename Op1 = std::plus<>,
+        typename Op2 = std::multiplies<>,
+        typename IndexProj = get_fn<0>,
+        typename ValueProj = get_fn<1>>
+    constexpr auto operator()(R1&& r1, R2&& r2, T init,
+                              Op1 op1 = Op1{}, Op2 op2 = Op2{},
+                              IndexProj iproj = IndexProj{},
+                              ValueProj vproj = ValueProj{}) const
+    -> std::enable_if_t<rng::input_range<R1> && rng::input_range<R2>,
+        T>
+    {
+        return (*this)(rng::begin(r1), rng::end(r1),
+                       rng::begin(r2), rng::end(r2),
+                       std::move(init), std::move(op1), std::move(op2),
+                       std::move(iproj), std::move(vproj));
+    }
+};
+
+} // detail
+
+// sparse_inner_product(sparse, dense, init) is init plus the sum of each
+// value of sparse times the element of dense at its index. Contiguous
+// arithmetic data is summed in independent lanes, so, as with
+// transform_reduce, floating-point results may differ by rounding from
+// summing in order.
+inline constexpr auto sparse_inner_product = detail::sparse_inner_product_fn{};
+
+inline constexpr auto sparse_sparse_inner_product = detail::sparse_sparse_inner_product_fn{};
+
+}}
+
+#endif
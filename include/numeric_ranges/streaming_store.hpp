@@ -0,0 +1,227 @@
+// numeric_ranges/streaming_store.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_STREAMING_STORE_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_STREAMING_STORE_HPP_INCLUDED
+
+#include "core.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TCB_NUMERIC_RANGES_HAVE_STREAM_STORES
+#endif
+
+namespace tcb {
+inline namespace ranges {
+
+// Outputs of at least this many bytes are written with streaming stores
+// by default: large enough that the output would not have stayed in cache
+// anyway
+inline constexpr std::size_t default_streaming_threshold = std::size_t{1} << 22;
+
+// An output iterator wrapping a T*, which asks iota, partial_sum and
+// adjacent_difference to write their output with non-temporal stores.
+// These bypass the cache, so a large output neither evicts the working
+// set nor costs a read-for-ownership of each line before it is written.
+//
+// Streaming applies when the output is at least `threshold` bytes and the
+// algorithm works on arithmetic values of the output's type: iota with a
+// value of that type, or partial_sum and adjacent_difference over
+// contiguous input with the default operation and projection. Otherwise
+// the output is written through the plain pointer as usual. Only use it
+// for outputs which will not be read again soon.
+template <typename T>
+class streaming_store_iterator {
+public:
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+    using iterator_category = std::output_iterator_tag;
+
+    constexpr streaming_store_iterator() = default;
+
+    constexpr explicit streaming_store_iterator(
+            T* ptr, std::size_t threshold = default_streaming_threshold)
+        : ptr_(ptr), threshold_(threshold)
+    {}
+
+    constexpr T* base() const { return ptr_; }
+
+    constexpr std::size_t threshold() const { return threshold_; }
+
+    // True if an output of n elements should be streamed
+    constexpr bool streams(std::ptrdiff_t n) const
+    {
+        return static_cast<std::size_t>(n) * sizeof(T) >= threshold_;
+    }
+
+    constexpr T& operator*() const { return *ptr_; }
+
+    constexpr streaming_store_iterator& operator++()
+    {
+        ++ptr_;
+        return *this;
+    }
+
+    constexpr streaming_store_iterator operator++(int)
+    {
+        auto tmp = *this;
+        ++ptr_;
+        return tmp;
+    }
+
+    constexpr streaming_store_iterator& operator+=(difference_type n)
+    {
+        ptr_ += n;
+        return *this;
+    }
+
+    friend constexpr streaming_store_iterator
+    operator+(streaming_store_iterator it, difference_type n)
+    {
+        return it += n;
+    }
+
+    friend constexpr bool operator==(const streaming_store_iterator& lhs,
+                                     const streaming_store_iterator& rhs)
+    {
+        return lhs.ptr_ == rhs.ptr_;
+    }
+
+    friend constexpr bool operator!=(const streaming_store_iterator& lhs,
+                                     const streaming_store_iterator& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend constexpr difference_type operator-(const streaming_store_iterator& lhs,
+                                               const streaming_store_iterator& rhs)
+    {
+        return lhs.ptr_ - rhs.ptr_;
+    }
+
+    // The end of the output can be given as a plain pointer, as in
+    // iota(streaming_store(p), p + n, value)
+    friend constexpr bool operator==(const streaming_store_iterator& i, T* s)
+    {
+        return i.ptr_ == s;
+    }
+
+    friend constexpr bool operator==(T* s, const streaming_store_iterator& i)
+    {
+        return i.ptr_ == s;
+    }
+
+    friend constexpr bool operator!=(const streaming_store_iterator& i, T* s)
+    {
+        return i.ptr_ != s;
+    }
+
+    friend constexpr bool operator!=(T* s, const streaming_store_iterator& i)
+    {
+        return i.ptr_ != s;
+    }
+
+    friend constexpr difference_type operator-(T* s, const streaming_store_iterator& i)
+    {
+        return s - i.ptr_;
+    }
+
+    friend constexpr difference_type operator-(const streaming_store_iterator& i, T* s)
+    {
+        return i.ptr_ - s;
+    }
+
+private:
+    T* ptr_ = nullptr;
+    std::size_t threshold_ = default_streaming_threshold;
+};
+
+namespace detail {
+
+template <typename O>
+inline constexpr bool is_streaming_store_v = false;
+
+template <typename T>
+inline constexpr bool is_streaming_store_v<streaming_store_iterator<T>> = true;
+
+// Copies n elements from src to dst, writing dst with non-temporal stores
+// where the target supports them. The caller must call stream_fence()
+// before the output is used by another thread.
+template <typename E>
+void stream_copy(const E* src, E* dst, std::ptrdiff_t n) noexcept
+{
+#if defined(TCB_NUMERIC_RANGES_HAVE_STREAM_STORES)
+    if constexpr (16 % sizeof(E) == 0) {
+        while (n > 0 && reinterpret_cast<std::uintptr_t>(dst) % 16 != 0) {
+            *dst++ = *src++;
+            --n;
+        }
+        constexpr std::ptrdiff_t L = 16 / sizeof(E);
+        for (; n >= L; n -= L, src += L, dst += L) {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+        }
+    }
+#endif
+    std::memcpy(dst, src, static_cast<std::size_t>(n) * sizeof(E));
+}
+
+inline void stream_fence() noexcept
+{
+#if defined(TCB_NUMERIC_RANGES_HAVE_STREAM_STORES)
+    _mm_sfence();
+#endif
+}
+
+// Produces n elements of output in blocks small enough to stay in L1,
+// calling fill(stage, offset, m) to compute the m elements starting at
+// offset into stage, then streams each block to out
+template <typename E, typename Fill>
+void stream_blocks(E* out, std::ptrdiff_t n, Fill fill)
+{
+    constexpr std::ptrdiff_t B = 4096 / sizeof(E);
+    alignas(64) E stage[B];
+
+    for (std::ptrdiff_t i = 0; i < n; i += B) {
+        const std::ptrdiff_t m = n - i < B ? n - i : B;
+        fill(stage, i, m);
+        stream_copy(stage, out + i, m);
+    }
+    stream_fence();
+}
+
+struct streaming_store_fn {
+    template <typename T>
+    constexpr streaming_store_iterator<T>
+    operator()(T* ptr, std::size_t threshold = default_streaming_threshold) const
+    {
+        return streaming_store_iterator<T>(ptr, threshold);
+    }
+
+    template <typename R>
+    constexpr auto operator()(R&& r, std::size_t threshold = default_streaming_threshold) const
+    -> std::enable_if_t<
+        rng::contiguous_range<R> && !std::is_pointer_v<std::decay_t<R>>,
+        streaming_store_iterator<std::remove_reference_t<rng::range_reference_t<R>>>>
+    {
+        return streaming_store_iterator<std::remove_reference_t<rng::range_reference_t<R>>>(
+            rng::data(r), threshold);
+    }
+};
+
+} // detail
+
+// streaming_store(ptr, threshold) or streaming_store(contiguous_range,
+// threshold) returns a streaming_store_iterator to the start of the output
+inline constexpr auto streaming_store = detail::streaming_store_fn{};
+
+}}
+
+#endif
@@ -0,0 +1,315 @@
+// numeric_ranges/strided_span.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_NUMERIC_RANGES_STRIDED_SPAN_HPP_INCLUDED
+#define TCB_NUMERIC_RANGES_STRIDED_SPAN_HPP_INCLUDED
+
+#include "core.hpp"
+
+#include <cstring>
+
+namespace tcb {
+inline namespace ranges {
+
+template <typename T>
+class strided_span;
+
+namespace detail {
+
+// The iterator of strided_span<T>. It holds the base pointer and an index,
+// rather than a pointer to the current element, so that the end iterator
+// does not point outside the underlying array.
+template <typename T>
+class strided_iterator {
+    template <typename>
+    friend class tcb::ranges::strided_span;
+
+    T* data_ = nullptr;
+    std::ptrdiff_t stride_ = 1;
+    std::ptrdiff_t pos_ = 0;
+
+    constexpr strided_iterator(T* data, std::ptrdiff_t stride, std::ptrdiff_t pos)
+        : data_(data), stride_(stride), pos_(pos)
+    {}
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    strided_iterator() = default;
+
+    constexpr T& operator*() const { return data_[pos_ * stride_]; }
+    constexpr T* operator->() const { return data_ + pos_ * stride_; }
+    constexpr T& operator[](std::ptrdiff_t n) const { return data_[(pos_ + n) * stride_]; }
+
+    // The distance in elements of T between consecutive elements
+    constexpr std::ptrdiff_t stride() const { return stride_; }
+
+    constexpr strided_iterator& operator++() { ++pos_; return *this; }
+    constexpr strided_iterator operator++(int) { auto tmp = *this; ++pos_; return tmp; }
+    constexpr strided_iterator& operator--() { --pos_; return *this; }
+    constexpr strided_iterator operator--(int) { auto tmp = *this; --pos_; return tmp; }
+    constexpr strided_iterator& operator+=(std::ptrdiff_t n) { pos_ += n; return *this; }
+    constexpr strided_iterator& operator-=(std::ptrdiff_t n) { pos_ -= n; return *this; }
+
+    friend constexpr strided_iterator operator+(strided_iterator it, std::ptrdiff_t n)
+    {
+        return it += n;
+    }
+
+    friend constexpr strided_iterator operator+(std::ptrdiff_t n, strided_iterator it)
+    {
+        return it += n;
+    }
+
+    friend constexpr strided_iterator operator-(strided_iterator it, std::ptrdiff_t n)
+    {
+        return it -= n;
+    }
+
+    friend constexpr std::ptrdiff_t operator-(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return lhs.pos_ - rhs.pos_;
+    }
+
+    friend constexpr bool operator==(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return lhs.pos_ == rhs.pos_;
+    }
+
+    friend constexpr bool operator!=(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return lhs.pos_ != rhs.pos_;
+    }
+
+    friend constexpr bool operator<(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return lhs.pos_ < rhs.pos_;
+    }
+
+    friend constexpr bool operator>(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return lhs.pos_ > rhs.pos_;
+    }
+
+    friend constexpr bool operator<=(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return lhs.pos_ <= rhs.pos_;
+    }
+
+    friend constexpr bool operator>=(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return lhs.pos_ >= rhs.pos_;
+    }
+};
+
+} // namespace detail
+
+// A view of size() elements of type T in memory, stride() elements apart:
+// data()[0], data()[stride()], data()[2 * stride()], ... -- such as a
+// column of a row-major matrix. The stride may be negative, or zero.
+//
+// Unlike a stride view over some other range, whose iterators must count
+// their way to the end of the underlying range, the elements are found by
+// pointer arithmetic, and accumulate, reduce, inner_product and
+// transform_reduce recognise strided_spans (and their iterators) and sum
+// them in independent lanes. Strided loads still touch a cache line per
+// element once the stride is wide, though; to reduce every column of a
+// row-major matrix, reduce_columns is much faster.
+template <typename T>
+class strided_span : public rng::view_interface<strided_span<T>> {
+public:
+    using iterator = detail::strided_iterator<T>;
+
+    strided_span() = default;
+
+    constexpr strided_span(T* data, std::size_t size, std::ptrdiff_t stride = 1)
+        : data_(data), size_(size), stride_(stride)
+    {}
+
+    template <typename U, std::enable_if_t<
+        std::is_convertible_v<U(*)[], T(*)[]>, int> = 0>
+    constexpr strided_span(const strided_span<U>& other)
+        : data_(other.data()), size_(other.size()), stride_(other.stride())
+    {}
+
+    constexpr iterator begin() const { return {data_, stride_, 0}; }
+    constexpr iterator end() const { return {data_, stride_, static_cast<std::ptrdiff_t>(size_)}; }
+
+    constexpr T* data() const { return data_; }
+    constexpr std::size_t size() const { return size_; }
+    constexpr std::ptrdiff_t stride() const { return stride_; }
+
+    constexpr T& operator[](std::size_t i) const
+    {
+        return data_[static_cast<std::ptrdiff_t>(i) * stride_];
+    }
+
+private:
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::ptrdiff_t stride_ = 1;
+};
+
+// A rows() x cols() matrix of T stored in row-major order, with the start
+// of each row row_stride() elements after the last (by default cols(), for
+// a packed matrix; larger for a block of a bigger matrix or padded rows)
+template <typename T>
+class matrix_view {
+public:
+    matrix_view() = default;
+
+    constexpr matrix_view(T* data, std::size_t rows, std::size_t cols)
+        : matrix_view(data, rows, cols, static_cast<std::ptrdiff_t>(cols))
+    {}
+
+    constexpr matrix_view(T* data, std::size_t rows, std::size_t cols,
+                          std::ptrdiff_t row_stride)
+        : data_(data), rows_(rows), cols_(cols), row_stride_(row_stride)
+    {}
+
+    template <typename U, std::enable_if_t<
+        std::is_convertible_v<U(*)[], T(*)[]>, int> = 0>
+    constexpr matrix_view(const matrix_view<U>& other)
+        : matrix_view(other.data(), other.rows(), other.cols(), other.row_stride())
+    {}
+
+    constexpr T* data() const { return data_; }
+    constexpr std::size_t rows() const { return rows_; }
+    constexpr std::size_t cols() const { return cols_; }
+    constexpr std::ptrdiff_t row_stride() const { return row_stride_; }
+
+    constexpr T& operator()(std::size_t i, std::size_t j) const
+    {
+        return data_[static_cast<std::ptrdiff_t>(i) * row_stride_ +
+                     static_cast<std::ptrdiff_t>(j)];
+    }
+
+    constexpr strided_span<T> row(std::size_t i) const
+    {
+        return {data_ + static_cast<std::ptrdiff_t>(i) * row_stride_, cols_, 1};
+    }
+
+    constexpr strided_span<T> column(std::size_t j) const
+    {
+        return {data_ + static_cast<std::ptrdiff_t>(j), rows_, row_stride_};
+    }
+
+private:
+    T* data_ = nullptr;
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::ptrdiff_t row_stride_ = 0;
+};
+
+namespace detail {
+
+template <typename I>
+inline constexpr bool is_strided_iterator_v = false;
+
+template <typename T>
+inline constexpr bool is_strided_iterator_v<strided_iterator<T>> = true;
+
+// True if [I, S) is a strided_span's elements, or contiguous; either way
+// the kernels can address them as a pointer and a stride
+template <typename I, typename S>
+inline constexpr bool is_strided_sized_v =
+    (is_strided_iterator_v<I> && std::is_same_v<I, S>) || is_contiguous_sized_v<I, S>;
+
+// The stride of a strided or contiguous iterator
+template <typename I>
+constexpr std::ptrdiff_t iterator_stride(const I& it)
+{
+    if constexpr (is_strided_iterator_v<I>) {
+        return it.stride();
+    } else {
+        return 1;
+    }
+}
+
+// True if Proj is a pointer to an arithmetic data member of V (or of a base
+// of V). Over a contiguous range of V, the projected members are then
+// sizeof(V) bytes apart, which the strided kernels can read directly.
+template <typename Proj, typename V, typename = void>
+inline constexpr bool is_field_projection_v = false;
+
+template <typename M, typename C, typename V>
+inline constexpr bool is_field_projection_v<M C::*, V,
+    std::enable_if_t<std::is_arithmetic_v<M>>> = std::is_base_of_v<C, V>;
+
+// True if the elements of [I, S) under Proj lie a fixed stride apart in
+// memory: strided or contiguous elements themselves, or a data member of
+// each of a contiguous range of structs
+template <typename I, typename S, typename Proj>
+inline constexpr bool is_strided_projection_v =
+    (std::is_same_v<Proj, _std::identity> && is_strided_sized_v<I, S>) ||
+    (is_contiguous_sized_v<I, S> && is_field_projection_v<Proj, _std::iter_value_t<I>>);
+
+template <typename I, typename Proj>
+struct strided_value {
+    using type = _std::iter_value_t<I>;
+};
+
+template <typename I, typename M, typename C>
+struct strided_value<I, M C::*> {
+    using type = std::remove_cv_t<M>;
+};
+
+// The type of the elements of a strided projection
+template <typename I, typename Proj>
+using strided_value_t = typename strided_value<I, Proj>::type;
+
+// Elements of type E a fixed number of bytes apart in memory. The address
+// of each is formed from a byte pointer and it is read with memcpy, so the
+// elements may be members of separate structs rather than of one array,
+// and the step need not be a multiple of sizeof(E).
+template <typename E>
+struct strided_elements {
+    const unsigned char* data;
+    std::ptrdiff_t step;
+
+    E operator[](std::ptrdiff_t i) const
+    {
+        E e;
+        std::memcpy(&e, data + i * step, sizeof(E));
+        return e;
+    }
+};
+
+// The elements of a strided projection, starting at first
+template <typename I, typename Proj>
+strided_elements<strided_value_t<I, Proj>> strided_elements_of(const I& first, const Proj& proj)
+{
+    using E = strided_value_t<I, Proj>;
+    if constexpr (std::is_same_v<Proj, _std::identity>) {
+        return {reinterpret_cast<const unsigned char*>(std::addressof(*first)),
+                iterator_stride(first) * static_cast<std::ptrdiff_t>(sizeof(E))};
+    } else {
+        return {reinterpret_cast<const unsigned char*>(std::addressof(std::addressof(*first)->*proj)),
+                static_cast<std::ptrdiff_t>(sizeof(_std::iter_value_t<I>))};
+    }
+}
+
+} // namespace detail
+
+}}
+
+#ifdef TCB_NUMERIC_RANGES_USE_NANORANGE
+namespace nano {
+#else
+namespace std::ranges {
+#endif
+
+template <typename T>
+inline constexpr bool enable_borrowed_range<tcb::strided_span<T>> = true;
+
+}
+
+#endif
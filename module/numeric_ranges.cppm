@@ -0,0 +1,118 @@
+// numeric_ranges.cppm
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// C++20 module interface for the library, so that importers pay for parsing
+// the headers once per build rather than once per translation unit:
+//
+//     import tcb.numeric_ranges;
+//
+// The module always uses std ranges; TCB_NUMERIC_RANGES_USE_NANORANGE is a
+// C++17 configuration and is not supported here.
+
+module;
+
+// The umbrella header is included in the global module fragment, and only
+// its public names are exported below, so tcb::detail stays internal. The
+// specialisations the headers declare (such as enable_borrowed_range for
+// strided_span) are reachable through the exported names. mapped_column.hpp
+// and parse_numbers.hpp are not part of the umbrella header and are not
+// exported.
+#include <numeric_ranges.hpp>
+
+export module tcb.numeric_ranges;
+
+export namespace tcb {
+
+// accumulate.hpp, inner_product.hpp, iota.hpp, partial_sum.hpp and
+// adjacent_difference.hpp
+using tcb::ranges::accumulate;
+using tcb::ranges::reduce;
+using tcb::ranges::inner_product;
+using tcb::ranges::transform_reduce;
+using tcb::ranges::iota;
+using tcb::ranges::partial_sum;
+using tcb::ranges::partial_sum_result;
+using tcb::ranges::adjacent_difference;
+using tcb::ranges::adjacent_difference_result;
+using tcb::ranges::compound_assign;
+
+// moments.hpp
+using tcb::ranges::moments;
+using tcb::ranges::moments_result;
+using tcb::ranges::higher_moments;
+using tcb::ranges::higher_moments_result;
+
+// minmax_reduce.hpp
+using tcb::ranges::min_reduce;
+using tcb::ranges::max_reduce;
+using tcb::ranges::minmax_reduce;
+using tcb::ranges::minmax_reduce_result;
+using tcb::ranges::argmin;
+using tcb::ranges::argmax;
+
+// moving_sum.hpp and moving_reduce.hpp
+using tcb::ranges::moving_sum;
+using tcb::ranges::moving_sum_result;
+using tcb::ranges::sliding_sum_view;
+using tcb::ranges::moving_min;
+using tcb::ranges::moving_max;
+using tcb::ranges::moving_reduce;
+using tcb::ranges::moving_reduce_result;
+using tcb::ranges::ring_buffer;
+using tcb::ranges::monotonic_window;
+using tcb::ranges::two_stacks_window;
+
+// inner_product_batch.hpp and sparse_inner_product.hpp
+using tcb::ranges::inner_product_batch;
+using tcb::ranges::inner_product_batch_result;
+using tcb::ranges::sparse_inner_product;
+using tcb::ranges::sparse_sparse_inner_product;
+
+// dispatch.hpp
+using tcb::ranges::simd_isa;
+using tcb::ranges::detected_simd_isa;
+using tcb::ranges::active_simd_isa;
+using tcb::ranges::set_simd_isa;
+
+// streaming_store.hpp and prefetch.hpp
+using tcb::ranges::streaming_store;
+using tcb::ranges::streaming_store_iterator;
+using tcb::ranges::prefetch_view;
+
+// delta_coding.hpp
+using tcb::ranges::delta_word_t;
+using tcb::ranges::delta_encode_bound;
+using tcb::ranges::delta_encode;
+using tcb::ranges::delta_encode_result;
+using tcb::ranges::delta_decode;
+using tcb::ranges::delta_decode_result;
+using tcb::ranges::delta_decoded_view;
+using tcb::ranges::reduce_delta_coded;
+
+// concat_reduce.hpp and segmented.hpp
+using tcb::ranges::concat_reduce;
+using tcb::ranges::segmented_iterator_traits;
+using tcb::ranges::segmented_range_traits;
+
+// strided_span.hpp and reduce_columns.hpp
+using tcb::ranges::strided_span;
+using tcb::ranges::matrix_view;
+using tcb::ranges::reduce_columns;
+
+// checked_accumulate.hpp and saturating.hpp
+using tcb::ranges::checked_accumulate;
+using tcb::ranges::checked_inner_product;
+using tcb::ranges::checked_result;
+using tcb::ranges::saturating_plus;
+using tcb::ranges::saturating_minus;
+
+namespace views {
+using tcb::ranges::views::sliding_sum;
+using tcb::ranges::views::prefetch;
+using tcb::ranges::views::delta_decoded;
+}
+
+}
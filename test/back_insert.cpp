@@ -0,0 +1,142 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+
+#include <deque>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+int allocations = 0;
+
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+
+    counting_allocator() = default;
+
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(std::size_t n)
+    {
+        ++allocations;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) { std::allocator<T>{}.deallocate(p, n); }
+
+    friend bool operator==(counting_allocator, counting_allocator) { return true; }
+    friend bool operator!=(counting_allocator, counting_allocator) { return false; }
+};
+
+template <typename T>
+using counted_vector = std::vector<T, counting_allocator<T>>;
+
+template <typename T>
+std::vector<T> make_input(int n)
+{
+    std::vector<T> vec;
+    for (int i = 0; i < n; ++i) {
+        vec.push_back(static_cast<T>((i * 37) % 101 - 50));
+    }
+    return vec;
+}
+
+}
+
+TEST_CASE("partial_sum reserves when appending to a container")
+{
+    const auto in = make_input<int>(10'000);
+
+    std::vector<int> expected(3 + in.size());
+    expected[0] = 1;
+    expected[1] = 2;
+    expected[2] = 3;
+    tcb::partial_sum(in, expected.data() + 3);
+
+    counted_vector<int> out{1, 2, 3};
+    allocations = 0;
+    const auto res = tcb::partial_sum(in, std::back_inserter(out));
+    REQUIRE(allocations == 1);
+    REQUIRE(res.in == in.end());
+    REQUIRE(std::vector<int>(out.begin(), out.end()) == expected);
+
+    // Operations which may throw are written through the iterator, into
+    // reserved space
+    counted_vector<int> out2{1, 2, 3};
+    allocations = 0;
+    tcb::partial_sum(in, std::back_inserter(out2), [](int a, int b) { return a + b; });
+    REQUIRE(allocations == 1);
+    REQUIRE(std::vector<int>(out2.begin(), out2.end()) == expected);
+}
+
+TEST_CASE("adjacent_difference reserves when appending to a container")
+{
+    const auto in = make_input<double>(10'000);
+
+    std::vector<double> expected(in.size());
+    tcb::adjacent_difference(in, expected.data());
+
+    counted_vector<double> out;
+    allocations = 0;
+    tcb::adjacent_difference(in, std::back_inserter(out));
+    REQUIRE(allocations == 1);
+    REQUIRE(std::vector<double>(out.begin(), out.end()) == expected);
+
+    counted_vector<double> out2;
+    allocations = 0;
+    tcb::adjacent_difference(in, std::back_inserter(out2), [](double a, double b) { return a - b; });
+    REQUIRE(allocations == 1);
+    REQUIRE(std::vector<double>(out2.begin(), out2.end()) == expected);
+}
+
+TEST_CASE("repeated appends grow the container geometrically")
+{
+    const int in[] = {1, 2, 3};
+
+    counted_vector<int> out;
+    allocations = 0;
+    for (int i = 0; i < 1000; ++i) {
+        tcb::partial_sum(in, std::back_inserter(out));
+    }
+    REQUIRE(out.size() == 3000);
+    REQUIRE(out[2997] == 1);
+    REQUIRE(out[2999] == 6);
+    REQUIRE(allocations < 30);
+}
+
+TEST_CASE("appending leaves no partial output behind when an operation throws")
+{
+    const auto in = make_input<int>(100);
+    std::vector<int> out{7};
+
+    int calls = 0;
+    const auto throwing = [&calls](int a, int b) {
+        if (++calls == 10) {
+            throw std::runtime_error("boom");
+        }
+        return a + b;
+    };
+    REQUIRE_THROWS(tcb::partial_sum(in, std::back_inserter(out), throwing));
+    REQUIRE(out.size() == 11);
+}
+
+TEST_CASE("appending to containers without reserve")
+{
+    const auto in = make_input<long>(1000);
+
+    std::deque<long> out;
+    tcb::partial_sum(in, std::back_inserter(out));
+
+    std::vector<long> expected(in.size());
+    tcb::partial_sum(in, expected.data());
+    REQUIRE(std::vector<long>(out.begin(), out.end()) == expected);
+}
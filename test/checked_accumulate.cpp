@@ -0,0 +1,164 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+#include "test_iterators.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <vector>
+
+namespace {
+
+struct payment {
+    int id;
+    std::int64_t cents;
+};
+
+template <typename T>
+constexpr T max_of = (std::numeric_limits<T>::max)();
+
+template <typename T>
+constexpr T min_of = (std::numeric_limits<T>::min)();
+
+}
+
+TEST_CASE("checked_accumulate")
+{
+    const int ia[] = {1, 2, 3, 4, 5, 6};
+
+    auto r = tcb::checked_accumulate(ia, 10);
+    CHECK(r.value == 31);
+    CHECK_FALSE(r.overflowed);
+
+    r = tcb::checked_accumulate(InputIterator<const int*>(ia),
+                                Sentinel<const int*>(ia + 6), 10);
+    CHECK(r.value == 31);
+    CHECK_FALSE(r.overflowed);
+
+    r = tcb::checked_accumulate(ia + 3, ia + 3, 7);
+    CHECK(r.value == 7);
+    CHECK_FALSE(r.overflowed);
+
+    // The result wraps, and is flagged
+    const int big[] = {max_of<int>, 1};
+    r = tcb::checked_accumulate(big, 0);
+    CHECK(r.value == min_of<int>);
+    CHECK(r.overflowed);
+
+    // Only the exact total is checked, not each partial sum
+    const int back_again[] = {max_of<int>, 1, -1};
+    r = tcb::checked_accumulate(back_again, 0);
+    CHECK(r.value == max_of<int>);
+    CHECK_FALSE(r.overflowed);
+
+    // A negative total does not fit an unsigned result
+    const int negative[] = {3, -5};
+    const auto u = tcb::checked_accumulate(negative, 1u);
+    CHECK(u.value == max_of<unsigned>);
+    CHECK(u.overflowed);
+
+    const std::list<payment> payments = {{1, max_of<std::int64_t>}, {2, -5}, {3, 5}};
+    auto p = tcb::checked_accumulate(payments, std::int64_t(0), &payment::cents);
+    CHECK(p.value == max_of<std::int64_t>);
+    CHECK_FALSE(p.overflowed);
+    p = tcb::checked_accumulate(payments, std::int64_t(1), &payment::cents);
+    CHECK(p.value == min_of<std::int64_t>);
+    CHECK(p.overflowed);
+}
+
+TEST_CASE("checked_accumulate of contiguous ranges")
+{
+    for (std::size_t n : {0, 1, 7, 16, 17, 100, 1001}) {
+        std::vector<std::int32_t> v(n, max_of<std::int32_t>);
+        const auto total = std::int64_t(max_of<std::int32_t>) * std::int64_t(n);
+
+        auto r = tcb::checked_accumulate(v, std::int64_t(-3));
+        CHECK(r.value == total - 3);
+        CHECK_FALSE(r.overflowed);
+
+        auto r32 = tcb::checked_accumulate(v, std::int32_t(0));
+        CHECK(r32.value == static_cast<std::int32_t>(static_cast<std::uint32_t>(total)));
+        CHECK(r32.overflowed == (n > 1));
+
+        std::vector<std::uint16_t> small(n, 65535);
+        const auto s = tcb::checked_accumulate(small, std::uint32_t(0));
+        CHECK(s.value == 65535u * n);
+        CHECK_FALSE(s.overflowed);
+        CHECK(tcb::checked_accumulate(small, std::uint16_t(0)).overflowed == (n > 1));
+
+        // 64-bit elements, alternating to stay in range
+        std::vector<std::int64_t> w(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            w[i] = i % 2 == 0 ? max_of<std::int64_t> : -max_of<std::int64_t>;
+        }
+        const auto r64 = tcb::checked_accumulate(w, std::int64_t(0));
+        CHECK(r64.value == (n % 2 == 0 ? 0 : max_of<std::int64_t>));
+        CHECK_FALSE(r64.overflowed);
+
+        std::vector<std::uint64_t> uw(n, max_of<std::uint64_t>);
+        const auto ru = tcb::checked_accumulate(uw, std::uint64_t(0));
+        CHECK(ru.value == max_of<std::uint64_t> * n);
+        CHECK(ru.overflowed == (n > 1));
+        CHECK(tcb::checked_accumulate(w, std::int64_t(1)).overflowed == (n % 2 == 1));
+    }
+}
+
+TEST_CASE("checked_inner_product")
+{
+    const int ia[] = {1, 2, 3};
+    const short ib[] = {4, 5, 6, 7};
+
+    auto r = tcb::checked_inner_product(ia, ib, 1);
+    CHECK(r.value == 33);
+    CHECK_FALSE(r.overflowed);
+
+    r = tcb::checked_inner_product(InputIterator<const int*>(ia), Sentinel<const int*>(ia + 3),
+                                   ib, ib + 4, 0, [](int x) { return -x; });
+    CHECK(r.value == -32);
+    CHECK_FALSE(r.overflowed);
+
+    for (std::size_t n : {0, 1, 2, 15, 16, 33, 1000}) {
+        std::vector<std::int32_t> a(n, min_of<std::int32_t>);
+        std::vector<std::int32_t> b(n, min_of<std::int32_t>);
+        // Each product is 2^62: twice that overflows an int64
+        const auto r64 = tcb::checked_inner_product(a, b, std::int64_t(0));
+        CHECK(r64.overflowed == (n > 1));
+        if (n == 1) {
+            CHECK(r64.value == std::int64_t(1) << 62);
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            b[i] = i % 2 == 0 ? max_of<std::int32_t> : min_of<std::int32_t>;
+        }
+        // Alternately -2^31 * (2^31 - 1) and 2^62; the pairs sum to 2^31
+        const auto alt = tcb::checked_inner_product(a, b, std::int64_t(0));
+        const std::int64_t pairs = std::int64_t(n / 2) << 31;
+        CHECK(alt.value == (n % 2 == 0 ? pairs : pairs - (std::int64_t(max_of<std::int32_t>) << 31)));
+        CHECK_FALSE(alt.overflowed);
+
+        std::vector<std::uint32_t> ua(n, max_of<std::uint32_t>);
+        const auto ru = tcb::checked_inner_product(ua, ua, std::uint64_t(0));
+        const std::uint64_t sq = std::uint64_t(max_of<std::uint32_t>) * max_of<std::uint32_t>;
+        CHECK(ru.value == sq * n);
+        CHECK(ru.overflowed == (n > 1));
+    }
+}
+
+TEST_CASE("checked_accumulate is constexpr")
+{
+    constexpr auto check = [] {
+        const std::int64_t a[] = {max_of<std::int64_t>, 1, -2};
+        const auto r = tcb::checked_accumulate(a, std::int64_t(0));
+        const int b[] = {-3, 4};
+        const auto s = tcb::checked_inner_product(b, b, 0u);
+        return r.value == max_of<std::int64_t> - 1 && !r.overflowed &&
+               s.value == 25u && !s.overflowed;
+    };
+    static_assert(check());
+}
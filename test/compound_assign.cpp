@@ -0,0 +1,209 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <valarray>
+#include <vector>
+
+namespace {
+
+// A fixed-size vector of longs which counts its heap allocations. Like
+// std::valarray, + and * allocate a new result, while +=, *= and
+// assignment between vectors of the same size reuse existing storage.
+class heavy {
+public:
+    static inline int allocations = 0;
+
+    explicit heavy(std::size_t n = 4, long value = 0) : n_(n), data_(allocate(n))
+    {
+        std::fill_n(data_.get(), n_, value);
+    }
+
+    heavy(const heavy& other) : n_(other.n_), data_(allocate(n_))
+    {
+        std::copy_n(other.data_.get(), n_, data_.get());
+    }
+
+    heavy(heavy&&) noexcept = default;
+
+    heavy& operator=(const heavy& other)
+    {
+        if (n_ != other.n_) {
+            data_ = allocate(other.n_);
+            n_ = other.n_;
+        }
+        std::copy_n(other.data_.get(), n_, data_.get());
+        return *this;
+    }
+
+    heavy& operator=(heavy&&) noexcept = default;
+
+    heavy& operator+=(const heavy& other)
+    {
+        for (std::size_t i = 0; i < n_; ++i) {
+            data_[i] += other.data_[i];
+        }
+        return *this;
+    }
+
+    heavy& operator*=(const heavy& other)
+    {
+        for (std::size_t i = 0; i < n_; ++i) {
+            data_[i] *= other.data_[i];
+        }
+        return *this;
+    }
+
+    friend heavy operator+(const heavy& lhs, const heavy& rhs)
+    {
+        heavy res(lhs);
+        return res += rhs;
+    }
+
+    friend heavy operator*(const heavy& lhs, const heavy& rhs)
+    {
+        heavy res(lhs);
+        return res *= rhs;
+    }
+
+    long operator[](std::size_t i) const { return data_[i]; }
+
+private:
+    static std::unique_ptr<long[]> allocate(std::size_t n)
+    {
+        ++allocations;
+        return std::make_unique<long[]>(n);
+    }
+
+    std::size_t n_;
+    std::unique_ptr<long[]> data_;
+};
+
+std::vector<heavy> make_heavies(std::size_t n)
+{
+    std::vector<heavy> vec;
+    for (std::size_t i = 0; i < n; ++i) {
+        vec.emplace_back(4, static_cast<long>(i % 7) + 1);
+    }
+    return vec;
+}
+
+// A user-defined operation, with and without a compound_assign
+// specialisation
+struct add_heavy {
+    heavy operator()(const heavy& lhs, const heavy& rhs) const { return lhs + rhs; }
+};
+
+struct add_heavy_slowly {
+    heavy operator()(const heavy& lhs, const heavy& rhs) const { return lhs + rhs; }
+};
+
+}
+
+namespace tcb {
+
+template <>
+struct compound_assign<add_heavy> {
+    static void apply(heavy& acc, const heavy& x) { acc += x; }
+};
+
+}
+
+TEST_CASE("accumulate and reduce accumulate in place")
+{
+    const auto vec = make_heavies(100);
+    const long expected = tcb::accumulate(vec, 0L, {}, [](const heavy& h) { return h[0]; });
+
+    for (int k = 0; k < 2; ++k) {
+        heavy init(4, 0);
+        heavy::allocations = 0;
+        const heavy res = k == 0 ? tcb::accumulate(vec, std::move(init))
+                                 : tcb::reduce(vec, std::move(init), std::plus<heavy>{});
+        REQUIRE(heavy::allocations == 0);
+        REQUIRE(res[0] == expected);
+        REQUIRE(res[3] == expected);
+    }
+}
+
+TEST_CASE("accumulate uses compound_assign for user operations")
+{
+    const auto vec = make_heavies(100);
+
+    heavy::allocations = 0;
+    const heavy fast = tcb::accumulate(vec, heavy(4, 0), add_heavy{});
+    REQUIRE(heavy::allocations == 1); // the initial value
+
+    heavy::allocations = 0;
+    const heavy slow = tcb::accumulate(vec, heavy(4, 0), add_heavy_slowly{});
+    REQUIRE(heavy::allocations > 100);
+
+    REQUIRE(fast[0] == slow[0]);
+}
+
+TEST_CASE("accumulate with multiplies multiplies in place")
+{
+    std::vector<heavy> vec(10, heavy(4, 2));
+
+    heavy::allocations = 0;
+    const heavy res = tcb::accumulate(vec, heavy(4, 1), std::multiplies<>{});
+    REQUIRE(heavy::allocations == 1);
+    REQUIRE(res[2] == 1024);
+}
+
+TEST_CASE("inner_product forms products in a reused scratch value")
+{
+    const auto a = make_heavies(100);
+    const auto b = make_heavies(100);
+
+    long expected = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        expected += a[i][0] * b[i][0];
+    }
+
+    heavy::allocations = 0;
+    const heavy res = tcb::inner_product(a, b, heavy(4, 0));
+    // The initial value and the scratch product
+    REQUIRE(heavy::allocations == 2);
+    REQUIRE(res[1] == expected);
+
+    heavy::allocations = 0;
+    const heavy res2 = tcb::transform_reduce(a, b, heavy(4, 0));
+    REQUIRE(heavy::allocations == 2);
+    REQUIRE(res2[1] == expected);
+}
+
+TEST_CASE("partial_sum accumulates in place")
+{
+    const auto vec = make_heavies(100);
+    std::vector<heavy> out(vec.size());
+
+    heavy::allocations = 0;
+    tcb::partial_sum(vec, out.begin());
+    // Only the running sum itself; the outputs are assigned into
+    REQUIRE(heavy::allocations == 1);
+
+    long sum = 0;
+    for (std::size_t i = 0; i < vec.size(); ++i) {
+        sum += vec[i][0];
+        REQUIRE(out[i][0] == sum);
+    }
+}
+
+TEST_CASE("compound assignment works with std::valarray")
+{
+    const std::vector<std::valarray<double>> vec(50, std::valarray<double>{1.0, 2.0, 3.0});
+
+    const auto sum = tcb::accumulate(vec, std::valarray<double>(0.0, 3));
+    REQUIRE(sum[0] == 50.0);
+    REQUIRE(sum[2] == 150.0);
+
+    const auto prod = tcb::accumulate(vec, std::valarray<double>(1.0, 3), std::multiplies<>{});
+    REQUIRE(prod[1] == 1125899906842624.0); // 2^50
+}
@@ -0,0 +1,140 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+
+#include <forward_list>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef TCB_NUMERIC_RANGES_USE_NANORANGE
+#include <span>
+#endif
+
+namespace {
+
+int allocations = 0;
+
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+
+    counting_allocator() = default;
+
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(std::size_t n)
+    {
+        ++allocations;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) { std::allocator<T>{}.deallocate(p, n); }
+
+    friend bool operator==(counting_allocator, counting_allocator) { return true; }
+    friend bool operator!=(counting_allocator, counting_allocator) { return false; }
+};
+
+using counted_string = std::basic_string<char, std::char_traits<char>, counting_allocator<char>>;
+
+template <typename T>
+using counted_vector = std::vector<T, counting_allocator<T>>;
+
+std::vector<counted_string> make_lines(int n)
+{
+    std::vector<counted_string> lines;
+    for (int i = 0; i < n; ++i) {
+        lines.push_back(counted_string("log line number ") +
+                        counted_string(std::to_string(i).c_str()) + "\n");
+    }
+    return lines;
+}
+
+}
+
+TEST_CASE("accumulate allocates concatenated strings once")
+{
+    const auto lines = make_lines(1000);
+
+    counted_string expected;
+    for (const auto& l : lines) {
+        expected += l;
+    }
+
+    allocations = 0;
+    const auto joined = tcb::accumulate(lines, counted_string{});
+    REQUIRE(allocations == 1);
+    REQUIRE(joined == expected);
+
+    allocations = 0;
+    const auto joined2 = tcb::reduce(lines, counted_string("prefix: "), std::plus<counted_string>{});
+    REQUIRE(allocations == 1);
+    REQUIRE(joined2 == "prefix: " + expected);
+}
+
+TEST_CASE("accumulate concatenates strings from single-pass ranges")
+{
+    std::istringstream in("alpha beta gamma");
+    const auto joined = tcb::accumulate(tcb::rng::istream_view<std::string>(in),
+                                        std::string{});
+    REQUIRE(joined == "alphabetagamma");
+}
+
+TEST_CASE("concat_reduce concatenates strings")
+{
+    const auto lines = make_lines(1000);
+
+    allocations = 0;
+    const auto joined = tcb::concat_reduce(lines);
+    REQUIRE(allocations == 1);
+    REQUIRE(joined == tcb::accumulate(lines, counted_string{}));
+
+    const std::vector<std::string_view> words{"one", "two", "three"};
+    REQUIRE(tcb::concat_reduce(words, std::string("zero")) == "zeroonetwothree");
+    REQUIRE(tcb::concat_reduce(words.begin(), words.end(), std::string{}) == "onetwothree");
+
+    const std::vector<std::string> empty;
+    REQUIRE(tcb::concat_reduce(empty).empty());
+}
+
+TEST_CASE("concat_reduce concatenates vectors")
+{
+    std::vector<counted_vector<int>> chunks;
+    for (int i = 0; i < 100; ++i) {
+        chunks.emplace_back(static_cast<std::size_t>(i % 5), i);
+    }
+
+    allocations = 0;
+    const auto flat = tcb::concat_reduce(chunks);
+    REQUIRE(allocations == 1);
+
+    counted_vector<int> expected;
+    for (const auto& c : chunks) {
+        expected.insert(expected.end(), c.begin(), c.end());
+    }
+    REQUIRE(flat == expected);
+
+    std::forward_list<std::vector<int>> fl{{1, 2}, {}, {3}};
+    REQUIRE(tcb::concat_reduce(fl) == std::vector<int>{1, 2, 3});
+}
+
+#ifndef TCB_NUMERIC_RANGES_USE_NANORANGE
+TEST_CASE("concat_reduce concatenates spans into a container")
+{
+    const int a[] = {1, 2, 3};
+    const int b[] = {4, 5};
+    const std::vector<std::span<const int>> spans{a, b, a};
+
+    allocations = 0;
+    const auto flat = tcb::concat_reduce(spans, counted_vector<int>{});
+    REQUIRE(allocations == 1);
+    REQUIRE(flat == counted_vector<int>{1, 2, 3, 4, 5, 1, 2, 3});
+}
+#endif
@@ -0,0 +1,261 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <vector>
+
+namespace {
+
+template <typename T>
+void check_round_trip(const std::vector<T>& vec)
+{
+    using W = tcb::delta_word_t<T>;
+
+    std::vector<W> encoded(tcb::delta_encode_bound<T>(vec.size()));
+    const auto enc = tcb::delta_encode(vec, encoded.data());
+    REQUIRE(enc.in == vec.end());
+    REQUIRE(enc.out <= encoded.data() + encoded.size());
+    encoded.resize(static_cast<std::size_t>(enc.out - encoded.data()));
+
+    std::vector<T> decoded(vec.size());
+    const auto dec = tcb::delta_decode(encoded, decoded.data());
+    REQUIRE(dec.in == encoded.end());
+    REQUIRE(dec.out == decoded.data() + decoded.size());
+    REQUIRE(decoded == vec);
+
+    std::vector<T> appended;
+    tcb::delta_decode(encoded.begin(), encoded.end(), std::back_inserter(appended));
+    REQUIRE(appended == vec);
+}
+
+const std::size_t sizes[] = {0, 1, 2, 127, 128, 129, 1000};
+
+template <typename T>
+void test_round_trips()
+{
+    constexpr T lo = std::numeric_limits<T>::min();
+    constexpr T hi = std::numeric_limits<T>::max();
+
+    for (std::size_t n : sizes) {
+        std::vector<T> sorted, noisy, constant, extremes, small;
+        std::uint64_t state = 12345;
+        for (std::size_t i = 0; i < n; ++i) {
+            state = state * 6364136223846793005u + 1442695040888963407u;
+            sorted.push_back(static_cast<T>(1000 * i + (state >> 60)));
+            noisy.push_back(static_cast<T>(state >> 7));
+            constant.push_back(T(42));
+            extremes.push_back(i % 3 == 0 ? lo : i % 3 == 1 ? hi : T(0));
+            small.push_back(static_cast<T>(static_cast<T>(state >> 61) - T(3)));
+        }
+        check_round_trip(sorted);
+        check_round_trip(noisy);
+        check_round_trip(constant);
+        check_round_trip(extremes);
+        check_round_trip(small);
+    }
+}
+
+}
+
+TEST_CASE("delta_encode and delta_decode round trip")
+{
+    test_round_trips<std::int32_t>();
+    test_round_trips<std::uint32_t>();
+    test_round_trips<std::int64_t>();
+    test_round_trips<std::uint64_t>();
+}
+
+TEST_CASE("delta coding every bit width")
+{
+    // Deltas alternating between 0 and 2^k - 1 need exactly k bits after
+    // subtracting the frame of reference
+    for (int k = 0; k <= 32; ++k) {
+        std::vector<std::uint32_t> vec;
+        std::uint32_t x = 0;
+        const std::uint32_t step = k == 32 ? 0xFFFFFFFFu : (std::uint32_t(1) << k) - 1;
+        for (int i = 0; i < 300; ++i) {
+            x += (i % 2) ? step / 2 : 0;
+            vec.push_back(x);
+        }
+        check_round_trip(vec);
+    }
+
+    for (int k = 0; k <= 64; k += 3) {
+        std::vector<std::int64_t> vec;
+        std::uint64_t x = 0;
+        const std::uint64_t step = k == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << k) - 1;
+        for (int i = 0; i < 300; ++i) {
+            x += (i % 3) ? step : 0;
+            vec.push_back(static_cast<std::int64_t>(x));
+        }
+        check_round_trip(vec);
+    }
+}
+
+TEST_CASE("delta coding of sorted data is compact")
+{
+    // Timestamps one second apart, give or take 8ms
+    std::vector<std::int64_t> ts;
+    for (std::int64_t i = 0; i < 12'800; ++i) {
+        ts.push_back(1'600'000'000'000 + 1000 * i + (i * 7) % 16 - 8);
+    }
+
+    std::vector<std::uint64_t> encoded;
+    tcb::delta_encode(ts, std::back_inserter(encoded));
+
+    // The deltas lie in [985, 1015], so their zigzag codes lie in
+    // [1970, 2030] and need 6 bits each relative to the block minimum.
+    // The first block also holds the first timestamp itself, which needs
+    // 42 bits. Each block has two header words, and packs 128 values into
+    // 2 * b 64-bit words.
+    REQUIRE(encoded.size() == 1 + (2 + 2 * 42) + 99 * (2 + 2 * 6));
+
+    std::vector<std::int64_t> decoded;
+    tcb::delta_decode(encoded, std::back_inserter(decoded));
+    REQUIRE(decoded == ts);
+}
+
+TEST_CASE("delta coding works with non-contiguous ranges")
+{
+    std::list<int> lst;
+    for (int i = 0; i < 500; ++i) {
+        lst.push_back(i * i - 1000);
+    }
+
+    std::list<std::uint32_t> encoded;
+    tcb::delta_encode(lst, std::back_inserter(encoded));
+
+    std::list<int> decoded;
+    tcb::delta_decode(encoded, std::back_inserter(decoded));
+    REQUIRE(decoded == lst);
+}
+
+TEST_CASE("delta_decode stops at truncated input")
+{
+    std::vector<int> vec(300, 7);
+    std::vector<std::uint32_t> encoded;
+    tcb::delta_encode(vec, std::back_inserter(encoded));
+
+    for (std::size_t keep : {std::size_t(0), std::size_t(1), std::size_t(3),
+                             encoded.size() - 1}) {
+        std::vector<int> decoded;
+        tcb::delta_decode(encoded.begin(), encoded.begin() + keep,
+                          std::back_inserter(decoded));
+        REQUIRE(decoded.size() < vec.size());
+    }
+}
+
+TEST_CASE("delta coding is constexpr")
+{
+    constexpr auto round_trip = [] {
+        int in[200] = {};
+        for (int i = 0; i < 200; ++i) {
+            in[i] = i * 3 - (i % 5);
+        }
+        std::uint32_t encoded[tcb::delta_encode_bound<int>(200)] = {};
+        const auto enc = tcb::delta_encode(in, encoded);
+        int out[200] = {};
+        tcb::delta_decode(encoded, enc.out, out);
+        for (int i = 0; i < 200; ++i) {
+            if (out[i] != in[i]) {
+                return false;
+            }
+        }
+        return true;
+    };
+    static_assert(round_trip());
+}
+
+TEST_CASE("reduce_delta_coded reduces without decoding")
+{
+    for (std::size_t n : sizes) {
+        std::vector<std::int32_t> vec;
+        for (std::size_t i = 0; i < n; ++i) {
+            vec.push_back(static_cast<std::int32_t>(i * i % 1013) - 500);
+        }
+        std::vector<std::uint32_t> encoded;
+        tcb::delta_encode(vec, std::back_inserter(encoded));
+
+        // Values are converted to int32_t before widening, so negative
+        // values sum correctly into a wider accumulator
+        REQUIRE(tcb::reduce_delta_coded<std::int32_t>(encoded, std::int64_t{0}) ==
+                tcb::accumulate(vec, std::int64_t{0}));
+        REQUIRE(tcb::reduce_delta_coded<std::int32_t>(encoded.begin(), encoded.end()) ==
+                tcb::accumulate(vec, std::int32_t{0}));
+
+        const auto max_op = [](std::int32_t a, std::int32_t b) { return a < b ? b : a; };
+        REQUIRE(tcb::reduce_delta_coded<std::int32_t>(encoded, -1000, max_op) ==
+                tcb::accumulate(vec, -1000, max_op));
+
+        const std::list<std::uint32_t> lst(encoded.begin(), encoded.end());
+        REQUIRE(tcb::reduce_delta_coded<std::int32_t>(lst, std::int64_t{0}) ==
+                tcb::accumulate(vec, std::int64_t{0}));
+
+        // 64-bit values decoded as both signed and unsigned integers
+        std::vector<long long> wide;
+        for (std::size_t i = 0; i < n; ++i) {
+            wide.push_back((static_cast<long long>(i % 7) - 3) << 40);
+        }
+        std::vector<std::uint64_t> wide_encoded;
+        tcb::delta_encode(wide, std::back_inserter(wide_encoded));
+        REQUIRE(tcb::reduce_delta_coded<long long>(wide_encoded) == tcb::accumulate(wide, 0LL));
+        REQUIRE(tcb::reduce_delta_coded<std::uint64_t>(wide_encoded) ==
+                tcb::accumulate(wide, std::uint64_t{0}));
+    }
+}
+
+TEST_CASE("reduce_delta_coded is constexpr")
+{
+    constexpr auto reduce = [] {
+        int in[300] = {};
+        for (int i = 0; i < 300; ++i) {
+            in[i] = (i % 11) - 5;
+        }
+        std::uint32_t encoded[tcb::delta_encode_bound<int>(300)] = {};
+        tcb::delta_encode(in, encoded);
+        return tcb::reduce_delta_coded<int>(encoded) == tcb::accumulate(in, 0);
+    };
+    static_assert(reduce());
+}
+
+TEST_CASE("reduce_delta_coded stops at truncated input")
+{
+    std::vector<std::uint64_t> vec(300, 5);
+    std::vector<std::uint64_t> encoded;
+    tcb::delta_encode(vec, std::back_inserter(encoded));
+
+    // Only the first, complete, block is reduced
+    encoded.pop_back();
+    REQUIRE(tcb::reduce_delta_coded<std::uint64_t>(encoded) <= 5 * 256);
+}
+
+TEST_CASE("views::delta_decoded yields the decoded values")
+{
+    for (std::size_t n : sizes) {
+        std::vector<std::int64_t> vec;
+        for (std::size_t i = 0; i < n; ++i) {
+            vec.push_back(static_cast<std::int64_t>(i) * 1'000'003 - 7'000'000);
+        }
+        std::vector<std::uint64_t> encoded;
+        tcb::delta_encode(vec, std::back_inserter(encoded));
+
+        std::vector<std::int64_t> out;
+        for (std::int64_t x : tcb::views::delta_decoded<std::int64_t>(encoded)) {
+            out.push_back(x);
+        }
+        REQUIRE(out == vec);
+
+        auto view = encoded | tcb::views::delta_decoded<std::int64_t>;
+        REQUIRE(tcb::accumulate(view, std::int64_t{0}) ==
+                tcb::accumulate(vec, std::int64_t{0}));
+    }
+}
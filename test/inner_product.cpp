@@ -26,6 +26,10 @@
 #include "catch.hpp"
 #include "test_iterators.hpp"
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 
 namespace {
   struct S
@@ -43,7 +47,7 @@ namespace {
       // iterator test:
       auto it3 = [](int* b1, int l1, int* b2, int i)
       {
-        return tcb::inner_product(Iter1(b1), Sent1(b1+l1), Iter2(b2), tcb::rng::unreachable_sentinel, i);
+        return tcb::inner_product(Iter1(b1), Sent1(b1+l1), Iter2(b2), tcb::_std::unreachable_sentinel, i);
       };
       CHECK(it3(a, 0, b, 0) == 0);
       CHECK(it3(a, 0, b, 10) == 10);
@@ -71,7 +75,7 @@ namespace {
       auto rng3 = [](int* b1, int l1, int* b2, int i)
       {
         return tcb::inner_product(tcb::rng::subrange(Iter1(b1), Sent1(b1+l1)),
-                                  tcb::rng::subrange(Iter2(b2), tcb::rng::unreachable_sentinel), i);
+                                  tcb::rng::subrange(Iter2(b2), tcb::_std::unreachable_sentinel), i);
       };
       CHECK(rng3(a, 0, b, 0) == 0);
       CHECK(rng3(a, 0, b, 10)  == 10);
@@ -185,3 +189,73 @@ TEST_CASE("inner_product")
         CHECK(tcb::inner_product(a, b, 10) == 66);
     }
 }
+
+namespace {
+
+template <typename A, typename B, typename T>
+void test_widening(std::size_t n)
+{
+    std::vector<A> a(n);
+    std::vector<B> b(n);
+    std::int64_t ref = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        // Mostly extreme values, to catch any intermediate overflow
+        a[i] = (i % 3 == 0) ? std::numeric_limits<A>::min()
+                            : static_cast<A>(std::numeric_limits<A>::max() - i % 5);
+        b[i] = (i % 4 == 1) ? std::numeric_limits<B>::min()
+                            : static_cast<B>(std::numeric_limits<B>::max() - i % 7);
+        ref += std::int64_t(a[i]) * std::int64_t(b[i]);
+    }
+
+    // (Using pointers, as NanoRange doesn't consider vector iterators to
+    // be contiguous. The generic path overflows for uint16_t products.)
+    CHECK(tcb::inner_product(tcb::rng::subrange(a.data(), a.data() + n),
+                             tcb::rng::subrange(b.data(), b.data() + n), T(7))
+          == static_cast<T>(ref + 7));
+
+    // Mismatched lengths stop at the shorter range
+    if (n > 0) {
+        const std::int64_t last = std::int64_t(a[n - 1]) * std::int64_t(b[n - 1]);
+        CHECK(tcb::inner_product(a.data(), a.data() + n - 1, b.data(), b.data() + n, T(0))
+              == static_cast<T>(ref - last));
+    }
+}
+
+template <typename A, typename B>
+void test_widening_all()
+{
+    for (std::size_t n : {0, 1, 31, 1000, 70000, 600000}) {
+        test_widening<A, B, std::int64_t>(n);
+        test_widening<A, B, std::uint64_t>(n);
+    }
+    test_widening<A, B, std::int32_t>(100);
+}
+
+}
+
+TEST_CASE("inner_product (widening integer fast path)")
+{
+    test_widening_all<std::int8_t, std::int8_t>();
+    test_widening_all<std::uint8_t, std::int8_t>();
+    test_widening_all<std::uint8_t, std::uint8_t>();
+    test_widening_all<std::int16_t, std::int16_t>();
+    test_widening_all<std::int16_t, std::uint8_t>();
+    test_widening_all<std::uint16_t, std::uint16_t>();
+
+    // Typed ops and the iterator/sentinel form take the same path
+    std::int8_t a[] = {1, -2, 3, -4};
+    std::int8_t b[] = {5, 6, -7, 8};
+    CHECK(tcb::inner_product(a, b, 0L, std::plus<long>{}, std::multiplies<long>{}) == -60);
+    CHECK(tcb::inner_product(a, a + 4, b, b + 4, 0) == -60);
+
+#if defined(__SIZEOF_INT128__)
+    // A negative total is sign-extended into a 128-bit init
+    using tcb::detail::int128_t;
+    const std::vector<short> c{1, 2};
+    const std::vector<short> d{-5, -5};
+    CHECK(tcb::inner_product(c, d, int128_t(0)) == int128_t(-15));
+    CHECK(tcb::inner_product(c, d, int128_t(20)) == int128_t(5));
+    const std::vector<unsigned short> e{40000, 40000};
+    CHECK(tcb::inner_product(e, e, int128_t(0)) == int128_t(3'200'000'000));
+#endif
+}
@@ -0,0 +1,129 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+#include "test_iterators.hpp"
+
+#include <cstdint>
+#include <list>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+struct S {
+    int i;
+};
+
+template <typename Q, typename V, typename T>
+void test_contiguous(std::size_t nrows, std::size_t dim)
+{
+    std::vector<Q> query;
+    for (std::size_t i = 0; i < dim; ++i) {
+        query.push_back(static_cast<Q>(i % 13) - Q(6));
+    }
+
+    std::vector<std::vector<V>> rows(nrows);
+    for (std::size_t r = 0; r < nrows; ++r) {
+        // include some rows shorter and longer than the query
+        const std::size_t len = r % 5 == 3 ? dim / 2 : dim + r % 3;
+        for (std::size_t i = 0; i < len; ++i) {
+            rows[r].push_back(static_cast<V>((i * (r + 1)) % 7));
+        }
+    }
+
+    std::vector<T> out;
+    auto res = tcb::inner_product_batch(query, rows, std::back_inserter(out), T(3));
+    CHECK(res.in == rows.end());
+    REQUIRE(out.size() == nrows);
+
+    for (std::size_t r = 0; r < nrows; ++r) {
+        // small integer values, so exact even for floating point
+        CHECK(out[r] == tcb::inner_product(query, rows[r], T(3)));
+    }
+}
+
+}
+
+TEST_CASE("inner_product_batch")
+{
+    for (std::size_t nrows : {0, 1, 3, 4, 5, 9}) {
+        for (std::size_t dim : {0, 1, 7, 16, 33, 100}) {
+            test_contiguous<float, float, float>(nrows, dim);
+            test_contiguous<double, double, double>(nrows, dim);
+            test_contiguous<float, float, double>(nrows, dim);
+            test_contiguous<int, int, int>(nrows, dim);
+            test_contiguous<std::int8_t, std::int8_t, std::int32_t>(nrows, dim);
+            test_contiguous<std::int16_t, std::int16_t, std::int64_t>(nrows, dim);
+        }
+    }
+
+    // iterator/sentinel form, non-contiguous rows, ops and projections
+    {
+        S query[] = {{1}, {2}, {3}};
+        std::list<std::list<S>> rows{{{1}, {1}, {1}}, {{2}, {0}, {1}}, {}};
+        int out[3] = {0};
+
+        auto res = tcb::inner_product_batch(
+            ForwardIterator<const S*>(query), Sentinel<const S*>(query + 3),
+            rows.begin(), rows.end(), out, 0,
+            std::plus<>{}, std::multiplies<>{}, &S::i, &S::i);
+        CHECK(res.in == rows.end());
+        CHECK(res.out == out + 3);
+        CHECK(out[0] == 6);
+        CHECK(out[1] == 5);
+        CHECK(out[2] == 0);
+
+        tcb::inner_product_batch(query, rows, out, 1,
+                                 std::multiplies<>{}, std::plus<>{}, &S::i, &S::i);
+        CHECK(out[0] == 24);
+        CHECK(out[1] == 24);
+        CHECK(out[2] == 1);
+    }
+
+    // rows given as a range of non-owning views
+    {
+        const float query[] = {1.0f, 2.0f};
+        const float matrix[] = {1.0f, 1.0f, 2.0f, 3.0f, 0.5f, 0.5f};
+        std::vector<tcb::rng::subrange<const float*>> rows{
+            {matrix, matrix + 2}, {matrix + 2, matrix + 4}, {matrix + 4, matrix + 6}};
+        float out[3] = {};
+        tcb::inner_product_batch(query, rows, out, 0.0f);
+        CHECK(out[0] == 3.0f);
+        CHECK(out[1] == 8.0f);
+        CHECK(out[2] == 1.5f);
+    }
+
+    // integer init with floating-point elements sums as inner_product does,
+    // rather than truncating each element
+    {
+        const std::vector<double> query{1.5, -2.5, 0.5};
+        const std::vector<std::vector<double>> rows(5, std::vector<double>{2, 2, 2});
+        long out[5] = {};
+        tcb::inner_product_batch(query, rows, out, 0L);
+        for (long x : out) {
+            CHECK(x == tcb::inner_product(query, rows[0], 0L));
+            CHECK(x == -1);
+        }
+    }
+
+    // unsigned products wrap in 32 bits before they are added to a 64-bit
+    // init, as in inner_product
+    {
+        const std::vector<std::uint32_t> query(40, 65536u);
+        std::vector<std::vector<std::uint32_t>> rows;
+        for (std::uint32_t r = 0; r < 6; ++r) {
+            rows.emplace_back(40, 65536u + r);
+        }
+        long long out[6] = {};
+        tcb::inner_product_batch(query, rows, out, 5LL);
+        for (std::size_t r = 0; r < rows.size(); ++r) {
+            CHECK(out[r] == std::inner_product(query.begin(), query.end(),
+                                               rows[r].begin(), 5LL));
+        }
+    }
+}
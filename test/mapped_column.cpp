@@ -0,0 +1,165 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if __has_include(<sys/mman.h>)
+
+#include <numeric_ranges.hpp>
+#include <numeric_ranges/mapped_column.hpp>
+#include "catch.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+// A uniquely-named file in the temporary directory, removed on destruction
+struct temp_file {
+    std::string path;
+
+    temp_file(const void* bytes, std::size_t size)
+    {
+        char name[] = "/tmp/numeric_ranges_XXXXXX";
+        const int fd = ::mkstemp(name);
+        REQUIRE(fd >= 0);
+        path = name;
+        REQUIRE(::write(fd, bytes, size) == static_cast<ssize_t>(size));
+        ::close(fd);
+    }
+
+    template <typename T>
+    explicit temp_file(const std::vector<T>& vec)
+        : temp_file(vec.data(), vec.size() * sizeof(T))
+    {}
+
+    ~temp_file() { std::remove(path.c_str()); }
+};
+
+template <typename T>
+std::vector<T> make_column(std::size_t n)
+{
+    std::vector<T> vec;
+    for (std::size_t i = 0; i < n; ++i) {
+        vec.push_back(static_cast<T>(i % 97) - T(40));
+    }
+    return vec;
+}
+
+}
+
+TEST_CASE("mapped_column can be reduced in place")
+{
+    const auto vec = make_column<std::int64_t>(100'003);
+    const temp_file file(vec);
+
+    const tcb::mapped_column<std::int64_t> col(file.path);
+    REQUIRE(col.size() == vec.size());
+    REQUIRE(!col.empty());
+    REQUIRE(col[12345] == vec[12345]);
+
+    const auto sum = tcb::accumulate(col, std::int64_t{0});
+    REQUIRE(sum == std::accumulate(vec.begin(), vec.end(), std::int64_t{0}));
+
+    const auto sum2 = tcb::accumulate(col.begin(), col.end(), std::int64_t{0});
+    REQUIRE(sum2 == sum);
+}
+
+TEST_CASE("mapped_column works with inner_product")
+{
+    const auto vec = make_column<double>(10'001);
+    const temp_file file(vec);
+
+    const tcb::mapped_column<double> col(file.path.c_str());
+    const double ip = tcb::inner_product(col, col, 0.0);
+    REQUIRE(ip == std::inner_product(vec.begin(), vec.end(), vec.begin(), 0.0));
+}
+
+TEST_CASE("mapped_column works with the scan algorithms")
+{
+    const auto vec = make_column<std::int64_t>(5'000);
+    const temp_file file(vec);
+
+    const tcb::mapped_column<std::int64_t> col(file.path);
+
+    std::vector<std::int64_t> out(col.size());
+    std::vector<std::int64_t> expected(vec.size());
+
+    tcb::partial_sum(col, out.data());
+    std::partial_sum(vec.begin(), vec.end(), expected.begin());
+    REQUIRE(out == expected);
+
+    tcb::adjacent_difference(col, out.data());
+    std::adjacent_difference(vec.begin(), vec.end(), expected.begin());
+    REQUIRE(out == expected);
+}
+
+TEST_CASE("mapped_column hints do not affect the contents")
+{
+    const auto vec = make_column<std::int32_t>(300'000);
+    const temp_file file(vec);
+
+    // No readahead up front, then hints covering the middle, the tail and
+    // beyond the end
+    const tcb::mapped_column<std::int32_t> col(file.path, 0);
+    col.will_need(1'001, 50'000);
+    col.will_need(col.size() - 1, 100);
+    col.will_need(col.size(), 1);
+    col.will_need(0, 0);
+
+    REQUIRE(tcb::accumulate(col, 0) == std::accumulate(vec.begin(), vec.end(), 0));
+}
+
+TEST_CASE("mapped_column of an empty file is empty")
+{
+    const temp_file file(nullptr, 0);
+
+    const tcb::mapped_column<double> col(file.path);
+    REQUIRE(col.empty());
+    REQUIRE(col.size() == 0);
+    REQUIRE(col.begin() == col.end());
+    REQUIRE(tcb::accumulate(col, 1.5) == 1.5);
+}
+
+TEST_CASE("mapped_column can be moved")
+{
+    const auto vec = make_column<std::int64_t>(1'000);
+    const temp_file file(vec);
+
+    tcb::mapped_column<std::int64_t> a(file.path);
+    const auto* data = a.data();
+
+    tcb::mapped_column<std::int64_t> b(std::move(a));
+    REQUIRE(b.data() == data);
+    REQUIRE(b.size() == vec.size());
+    REQUIRE(a.empty());
+
+    tcb::mapped_column<std::int64_t> c;
+    REQUIRE(c.empty());
+    c = std::move(b);
+    REQUIRE(c.data() == data);
+    REQUIRE(b.empty());
+    REQUIRE(tcb::accumulate(c, std::int64_t{0}) ==
+            std::accumulate(vec.begin(), vec.end(), std::int64_t{0}));
+}
+
+TEST_CASE("mapped_column reports errors")
+{
+    REQUIRE_THROWS_AS(tcb::mapped_column<double>("/nonexistent/column.bin"),
+                      std::system_error);
+
+    // Seven bytes is not a whole number of doubles
+    const char bytes[7] = {};
+    const temp_file file(bytes, sizeof(bytes));
+    REQUIRE_THROWS_AS(tcb::mapped_column<double>(file.path), std::system_error);
+    REQUIRE_NOTHROW(tcb::mapped_column<char>(file.path));
+}
+
+#endif // __has_include(<sys/mman.h>)
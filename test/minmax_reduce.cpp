@@ -0,0 +1,211 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+#include "test_iterators.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+struct S {
+    int i;
+};
+
+template <class Iter, class Sent = Iter>
+void test()
+{
+    int ia[] = {3, 1, 4, 1, 5, 9, 2, 6, 5};
+    constexpr auto sc = tcb::rng::size(ia);
+
+    CHECK(tcb::min_reduce(Iter(ia), Sent(ia)) == std::numeric_limits<int>::max());
+    CHECK(tcb::max_reduce(Iter(ia), Sent(ia)) == std::numeric_limits<int>::lowest());
+    CHECK(tcb::min_reduce(Iter(ia), Sent(ia), 10) == 10);
+    CHECK(tcb::min_reduce(Iter(ia), Sent(ia + 1)) == 3);
+    CHECK(tcb::min_reduce(Iter(ia), Sent(ia + sc)) == 1);
+    CHECK(tcb::min_reduce(Iter(ia), Sent(ia + sc), 0) == 0);
+    CHECK(tcb::max_reduce(Iter(ia), Sent(ia + sc)) == 9);
+    CHECK(tcb::max_reduce(Iter(ia), Sent(ia + sc), 10) == 10);
+
+    auto mm = tcb::minmax_reduce(Iter(ia), Sent(ia + sc));
+    CHECK(mm.min == 1);
+    CHECK(mm.max == 9);
+
+    using tcb::rng::subrange;
+    CHECK(tcb::min_reduce(subrange(Iter(ia), Sent(ia + sc))) == 1);
+    CHECK(tcb::max_reduce(subrange(Iter(ia), Sent(ia + sc))) == 9);
+    mm = tcb::minmax_reduce(subrange(Iter(ia), Sent(ia + sc)), {0, 0});
+    CHECK(mm.min == 0);
+    CHECK(mm.max == 9);
+}
+
+template <class Iter, class Sent = Iter>
+void test_arg()
+{
+    int ia[] = {3, 1, 4, 1, 5, 9, 2, 9, 5};
+    constexpr auto sc = tcb::rng::size(ia);
+
+    CHECK(base(tcb::argmin(Iter(ia), Sent(ia))) == ia);
+    CHECK(base(tcb::argmax(Iter(ia), Sent(ia))) == ia);
+    CHECK(base(tcb::argmin(Iter(ia), Sent(ia + sc))) == ia + 1);
+    CHECK(base(tcb::argmax(Iter(ia), Sent(ia + sc))) == ia + 5);
+
+    using tcb::rng::subrange;
+    CHECK(base(tcb::argmin(subrange(Iter(ia), Sent(ia + sc)))) == ia + 1);
+    CHECK(base(tcb::argmax(subrange(Iter(ia), Sent(ia + sc)))) == ia + 5);
+}
+
+template <typename T>
+void test_contiguous()
+{
+    for (std::size_t n = 0; n < 300; n += 7) {
+        std::vector<T> vec;
+        for (std::size_t i = 0; i < n; ++i) {
+            vec.push_back(static_cast<T>((i * 37) % 29) - T(10));
+        }
+
+        CHECK(tcb::min_reduce(vec) == tcb::min_reduce(
+            InputIterator<const T*>(vec.data()),
+            Sentinel<const T*>(vec.data() + n)));
+        CHECK(tcb::max_reduce(vec) == tcb::max_reduce(
+            InputIterator<const T*>(vec.data()),
+            Sentinel<const T*>(vec.data() + n)));
+
+        const auto mm = tcb::minmax_reduce(vec);
+        CHECK(mm.min == tcb::min_reduce(vec));
+        CHECK(mm.max == tcb::max_reduce(vec));
+
+        CHECK(tcb::argmin(vec) == std::min_element(vec.begin(), vec.end()));
+        CHECK(tcb::argmax(vec) == std::max_element(vec.begin(), vec.end()));
+    }
+}
+
+}
+
+TEST_CASE("min_reduce, max_reduce and minmax_reduce")
+{
+    test<InputIterator<const int*> >();
+    test<ForwardIterator<const int*> >();
+    test<BidirectionalIterator<const int*> >();
+    test<RandomAccessIterator<const int*> >();
+    test<const int*>();
+
+    test<InputIterator<const int*>, Sentinel<const int*> >();
+    test<ForwardIterator<const int*>, Sentinel<const int*> >();
+    test<BidirectionalIterator<const int*>, Sentinel<const int*> >();
+    test<RandomAccessIterator<const int*>, Sentinel<const int*> >();
+
+    test_contiguous<std::int8_t>();
+    test_contiguous<std::uint16_t>();
+    test_contiguous<int>();
+    test_contiguous<long long>();
+    test_contiguous<float>();
+    test_contiguous<double>();
+
+    // projections and comparators
+    {
+        S sa[] = {{3}, {1}, {4}, {1}, {5}};
+        CHECK(tcb::min_reduce(sa, 100, {}, &S::i) == 1);
+        CHECK(tcb::max_reduce(sa, 0, tcb::rng::greater{}, &S::i) == 0);
+        CHECK(tcb::argmax(sa, {}, &S::i) == sa + 4);
+        CHECK(tcb::argmin(sa, tcb::rng::greater{}, &S::i) == sa + 4);
+    }
+
+    // NaNs are skipped unless they come first
+    {
+        constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+        std::vector<double> vec(100, 1.0);
+        vec[50] = nan;
+        vec[70] = -1.0;
+        vec[90] = 2.0;
+        CHECK(tcb::min_reduce(vec) == -1.0);
+        CHECK(tcb::max_reduce(vec) == 2.0);
+        CHECK(tcb::argmin(vec) == vec.begin() + 70);
+        CHECK(tcb::argmax(vec) == vec.begin() + 90);
+
+        vec[0] = nan;
+        CHECK(tcb::argmin(vec) == vec.begin());
+        CHECK(tcb::argmax(vec) == vec.begin());
+        CHECK(std::isnan(tcb::min_reduce(vec, nan)));
+    }
+
+    // ties go to the first occurrence
+    {
+        std::vector<float> vec(1000, 0.0f);
+        vec[333] = -5.0f;
+        vec[666] = -5.0f;
+        vec[999] = -5.0f;
+        CHECK(tcb::argmin(vec) == vec.begin() + 333);
+        CHECK(tcb::argmax(vec) == vec.begin());
+    }
+
+    // of zeros of either sign, the first is returned, as by a sequential scan
+    for (std::size_t n : {3, 17, 100}) {
+        for (std::size_t first : {std::size_t(0), std::size_t(1), n - 1}) {
+            std::vector<double> vec(n, -0.0);
+            std::fill(vec.begin(), vec.begin() + first, 3.0);
+            for (std::size_t k = first; k < n; k += 3) {
+                vec[k] = 0.0;
+            }
+            CHECK(!std::signbit(tcb::min_reduce(vec)));
+            CHECK(!std::signbit(tcb::minmax_reduce(vec).min));
+
+            std::vector<double> neg(n);
+            std::transform(vec.begin(), vec.end(), neg.begin(), [](double x) { return -x; });
+            CHECK(std::signbit(tcb::max_reduce(neg)));
+            CHECK(std::signbit(tcb::minmax_reduce(neg).max));
+
+            // a zero init comes before every element
+            CHECK(std::signbit(tcb::min_reduce(vec, -0.0)));
+        }
+    }
+
+    // types without numeric_limits must be given an init
+    {
+        using strings = std::vector<std::string>;
+        using iter = strings::iterator;
+        static_assert(!std::is_invocable_v<decltype(tcb::min_reduce), strings&>);
+        static_assert(!std::is_invocable_v<decltype(tcb::max_reduce), strings&>);
+        static_assert(!std::is_invocable_v<decltype(tcb::minmax_reduce), strings&>);
+        static_assert(!std::is_invocable_v<decltype(tcb::min_reduce), iter, iter>);
+        static_assert(!std::is_invocable_v<decltype(tcb::minmax_reduce), iter, iter>);
+
+        const strings vec{"b", "a", "c"};
+        CHECK(tcb::min_reduce(vec, std::string("z")) == "a");
+        CHECK(tcb::max_reduce(vec, std::string()) == "c");
+        const auto mm = tcb::minmax_reduce(vec, {std::string("z"), std::string()});
+        CHECK(mm.min == "a");
+        CHECK(mm.max == "c");
+    }
+
+    // constexpr
+    {
+        constexpr int arr[] = {3, 1, 4, 1, 5};
+        static_assert(tcb::min_reduce(arr) == 1);
+        static_assert(tcb::max_reduce(arr) == 5);
+        static_assert(tcb::minmax_reduce(arr).max == 5);
+        static_assert(tcb::argmin(arr) == arr + 1);
+    }
+}
+
+TEST_CASE("argmin and argmax")
+{
+    test_arg<ForwardIterator<const int*> >();
+    test_arg<BidirectionalIterator<const int*> >();
+    test_arg<RandomAccessIterator<const int*> >();
+    test_arg<const int*>();
+
+    test_arg<ForwardIterator<const int*>, Sentinel<const int*> >();
+    test_arg<BidirectionalIterator<const int*>, Sentinel<const int*> >();
+    test_arg<RandomAccessIterator<const int*>, Sentinel<const int*> >();
+}
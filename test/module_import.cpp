@@ -0,0 +1,33 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Built only with BUILD_MODULE: checks that the public names are usable
+// through the module
+
+import tcb.numeric_ranges;
+
+#include <vector>
+
+int main()
+{
+    std::vector<int> v{3, 1, 4, 1, 5};
+    int out[5] = {};
+    tcb::partial_sum(v, out);
+    const auto mm = tcb::minmax_reduce(v);
+
+    int windows = 0;
+    for (int x : v | tcb::views::sliding_sum(2)) {
+        windows += x;
+    }
+
+    const bool ok = tcb::accumulate(v, 0) == 14 &&
+                    tcb::inner_product(v, v, 0) == 52 &&
+                    out[4] == 14 &&
+                    mm.min == 1 && mm.max == 5 &&
+                    tcb::argmax(v) == v.begin() + 4 &&
+                    windows == 20;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+#include "test_iterators.hpp"
+
+#include <vector>
+
+namespace {
+
+struct S {
+    int i;
+};
+
+// Straightforward two-pass reference implementation
+template <typename T>
+tcb::higher_moments_result<double> two_pass(const std::vector<T>& vec)
+{
+    tcb::higher_moments_result<double> res{};
+    res.count = static_cast<std::ptrdiff_t>(vec.size());
+    if (vec.empty()) {
+        return res;
+    }
+
+    double sum = 0;
+    for (auto x : vec) { sum += x; }
+    res.mean = sum / vec.size();
+    for (auto x : vec) {
+        const double d = x - res.mean;
+        res.m2 += d * d;
+        res.m3 += d * d * d;
+        res.m4 += d * d * d * d;
+    }
+    return res;
+}
+
+template <typename T>
+std::vector<T> make_data(std::size_t n)
+{
+    std::vector<T> vec;
+    for (std::size_t i = 0; i < n; ++i) {
+        vec.push_back(static_cast<T>((i * 7919) % 101) + T(1000));
+    }
+    return vec;
+}
+
+template <class Iter, class Sent = Iter>
+void test()
+{
+    int ia[] = {2, 4, 4, 4, 5, 5, 7, 9};
+    constexpr auto sc = tcb::rng::size(ia);
+
+    auto m = tcb::moments(Iter(ia), Sent(ia));
+    CHECK(m.count == 0);
+    CHECK(m.variance() == 0.0);
+
+    m = tcb::moments(Iter(ia), Sent(ia + 1));
+    CHECK(m.count == 1);
+    CHECK(m.mean == 2.0);
+    CHECK(m.sample_variance() == 0.0);
+
+    m = tcb::moments(Iter(ia), Sent(ia + sc));
+    CHECK(m.count == 8);
+    CHECK(m.mean == Approx(5.0));
+    CHECK(m.m2 == Approx(32.0));
+    CHECK(m.variance() == Approx(4.0));
+
+    m = tcb::moments(tcb::rng::subrange(Iter(ia), Sent(ia + sc)));
+    CHECK(m.count == 8);
+    CHECK(m.variance() == Approx(4.0));
+}
+
+}
+
+TEST_CASE("moments")
+{
+    test<InputIterator<const int*> >();
+    test<ForwardIterator<const int*> >();
+    test<BidirectionalIterator<const int*> >();
+    test<RandomAccessIterator<const int*> >();
+    test<const int*>();
+
+    test<InputIterator<const int*>, Sentinel<const int*> >();
+    test<ForwardIterator<const int*>, Sentinel<const int*> >();
+    test<BidirectionalIterator<const int*>, Sentinel<const int*> >();
+    test<RandomAccessIterator<const int*>, Sentinel<const int*> >();
+
+    // projections
+    {
+        S sa[] = {{2}, {4}, {4}, {4}, {5}, {5}, {7}, {9}};
+        auto m = tcb::moments(sa, &S::i);
+        CHECK(m.mean == Approx(5.0));
+        CHECK(m.variance() == Approx(4.0));
+    }
+
+    // floating point input stays floating point
+    {
+        float fa[] = {1.0f, 2.0f, 3.0f};
+        auto m = tcb::moments(fa);
+        static_assert(std::is_same_v<decltype(m), tcb::moments_result<float>>);
+        CHECK(m.mean == Approx(2.0f));
+    }
+
+    // contiguous inputs of every length around the lane width
+    for (std::size_t n = 0; n < 50; ++n) {
+        const auto vec = make_data<double>(n);
+        const auto ref = two_pass(vec);
+
+        const auto m = tcb::moments(vec);
+        CHECK(m.count == ref.count);
+        CHECK(m.mean == Approx(ref.mean));
+        CHECK(m.m2 == Approx(ref.m2).margin(1e-9));
+
+        const auto h = tcb::higher_moments(vec);
+        CHECK(h.count == ref.count);
+        CHECK(h.mean == Approx(ref.mean));
+        CHECK(h.m2 == Approx(ref.m2).margin(1e-9));
+        CHECK(h.m3 == Approx(ref.m3).margin(1e-6));
+        CHECK(h.m4 == Approx(ref.m4).margin(1e-6));
+
+        // Same result through the non-contiguous path
+        const auto hi = tcb::higher_moments(
+            InputIterator<const double*>(vec.data()),
+            Sentinel<const double*>(vec.data() + vec.size()));
+        CHECK(hi.m4 == Approx(h.m4).margin(1e-6));
+    }
+
+    // merging partial results
+    {
+        const auto vec = make_data<int>(1000);
+        const auto ref = tcb::higher_moments(vec);
+
+        auto a = tcb::higher_moments(vec.begin(), vec.begin() + 333);
+        const auto b = tcb::higher_moments(vec.begin() + 333, vec.end());
+        a.merge(b);
+
+        CHECK(a.count == ref.count);
+        CHECK(a.mean == Approx(ref.mean));
+        CHECK(a.m2 == Approx(ref.m2));
+        CHECK(a.m3 == Approx(ref.m3).margin(1e-6));
+        CHECK(a.m4 == Approx(ref.m4));
+        CHECK(a.skewness() == Approx(ref.skewness()).margin(1e-9));
+        CHECK(a.kurtosis() == Approx(ref.kurtosis()));
+    }
+
+    // constexpr
+    {
+        constexpr int arr[] = {1, 2, 3, 4, 5};
+        constexpr auto m = tcb::moments(arr);
+        static_assert(m.count == 5);
+        static_assert(m.mean == 3.0);
+        static_assert(m.m2 == 10.0);
+    }
+}
@@ -0,0 +1,253 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+#include "test_iterators.hpp"
+
+#include <algorithm>
+#include <list>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct S {
+    int i;
+};
+
+// Not default constructible, and counts the live objects of its type
+struct counted {
+    static inline int live = 0;
+
+    explicit counted(int v) : value(v) { ++live; }
+    counted(const counted& other) : value(other.value) { ++live; }
+    counted& operator=(const counted&) = default;
+    ~counted() { --live; }
+
+    friend counted operator+(const counted& a, const counted& b)
+    {
+        return counted(a.value + b.value);
+    }
+
+    friend bool operator<(const counted& a, const counted& b)
+    {
+        return a.value < b.value;
+    }
+
+    int value;
+};
+
+template <class InIter, class OutIter, class InSent = InIter>
+void test()
+{
+    using tcb::rng::subrange;
+
+    int ia[] = {4, 2, 12, 3, 8, 7, 1, 9};
+    const unsigned s = sizeof(ia) / sizeof(ia[0]);
+
+    { // iterator
+        int ir[] = {2, 2, 3, 3, 1, 1};
+        int ib[s] = {0};
+        auto r = tcb::moving_min(InIter(ia), InSent(ia + s), 3, OutIter(ib));
+        CHECK(base(r.in) == ia + s);
+        CHECK(base(r.out) == ib + 6);
+        for (unsigned i = 0; i < 6; ++i) { CHECK(ib[i] == ir[i]); }
+    }
+
+    { // range + output iterator
+        int ir[] = {12, 12, 12, 8, 8, 9};
+        int ib[s] = {0};
+        auto r = tcb::moving_max(subrange(InIter(ia), InSent(ia + s)), 3, OutIter(ib));
+        CHECK(base(r.in) == ia + s);
+        CHECK(base(r.out) == ib + 6);
+        for (unsigned i = 0; i < 6; ++i) { CHECK(ib[i] == ir[i]); }
+    }
+
+    { // generic op
+        int ir[] = {18, 17, 23, 18, 16, 17};
+        int ib[s] = {0};
+        auto r = tcb::moving_reduce(InIter(ia), InSent(ia + s), 3, OutIter(ib),
+                                    std::plus<>{});
+        CHECK(base(r.in) == ia + s);
+        CHECK(base(r.out) == ib + 6);
+        for (unsigned i = 0; i < 6; ++i) { CHECK(ib[i] == ir[i]); }
+    }
+
+    { // window longer than the range
+        int ib[s] = {0};
+        auto r = tcb::moving_min(InIter(ia), InSent(ia + s), s + 1, OutIter(ib));
+        CHECK(base(r.in) == ia + s);
+        CHECK(base(r.out) == ib);
+    }
+}
+
+template <typename F>
+std::vector<int> brute_force(const std::vector<int>& in, std::ptrdiff_t w, F f)
+{
+    std::vector<int> out;
+    for (std::ptrdiff_t i = 0; i + w <= static_cast<std::ptrdiff_t>(in.size()); ++i) {
+        out.push_back(f(in.begin() + i, in.begin() + i + w));
+    }
+    return out;
+}
+
+}
+
+TEST_CASE("moving_min, moving_max and moving_reduce")
+{
+    test<InputIterator<const int*>, ForwardIterator<int*> >();
+    test<InputIterator<const int*>, int*>();
+    test<ForwardIterator<const int*>, int*>();
+    test<RandomAccessIterator<const int*>, int*>();
+    test<const int*, int*>();
+
+    test<InputIterator<const int*>, int*, Sentinel<const int*> >();
+    test<RandomAccessIterator<const int*>, int*, Sentinel<const int*> >();
+
+    // compare against brute force
+    std::vector<int> in;
+    for (int i = 0; i < 500; ++i) {
+        in.push_back((i * 7919) % 211 - 100);
+    }
+
+    for (std::ptrdiff_t w : {1, 2, 3, 10, 64, 499, 500}) {
+        std::vector<int> out;
+
+        tcb::moving_min(in, w, std::back_inserter(out));
+        CHECK(out == brute_force(in, w, [](auto f, auto l) { return *std::min_element(f, l); }));
+
+        out.clear();
+        tcb::moving_max(in, w, std::back_inserter(out));
+        CHECK(out == brute_force(in, w, [](auto f, auto l) { return *std::max_element(f, l); }));
+
+        out.clear();
+        tcb::moving_reduce(in, w, std::back_inserter(out),
+                           [](int a, int b) { return a > b ? a : b; });
+        CHECK(out == brute_force(in, w, [](auto f, auto l) { return *std::max_element(f, l); }));
+
+        out.clear();
+        tcb::moving_reduce(in, w, std::back_inserter(out), std::plus<>{});
+        CHECK(out == brute_force(in, w, [](auto f, auto l) { return std::accumulate(f, l, 0); }));
+    }
+
+    // projections and comparators
+    {
+        S sa[] = {{3}, {1}, {4}, {1}, {5}};
+        int ib[3] = {0};
+        tcb::moving_min(sa, 3, ib, tcb::rng::greater{}, &S::i);
+        CHECK(ib[0] == 4);
+        CHECK(ib[1] == 4);
+        CHECK(ib[2] == 5);
+    }
+
+    // non-commutative ops are folded in order
+    {
+        std::vector<std::string> words{"a", "b", "c", "d", "e"};
+        std::vector<std::string> out;
+        tcb::moving_reduce(words, 3, std::back_inserter(out), std::plus<>{});
+        CHECK(out == std::vector<std::string>{"abc", "bcd", "cde"});
+    }
+
+    // a window longer than a sized input allocates nothing and writes nothing
+    {
+        constexpr std::ptrdiff_t huge = std::ptrdiff_t(1) << 60;
+        const std::vector<int> vec{3, 1, 4};
+        std::vector<int> out;
+        CHECK(tcb::moving_min(vec, huge, std::back_inserter(out)).in == vec.end());
+        CHECK(tcb::moving_max(vec.begin(), vec.end(), huge, std::back_inserter(out)).in == vec.end());
+        CHECK(tcb::moving_reduce(vec, huge, std::back_inserter(out), std::plus<>{}).in == vec.end());
+
+        const std::list<int> lst{3, 1, 4};
+        CHECK(tcb::moving_min(lst, huge, std::back_inserter(out)).in == lst.end());
+        CHECK(tcb::moving_reduce(lst, huge, std::back_inserter(out), std::plus<>{}).in == lst.end());
+        CHECK(out.empty());
+    }
+}
+
+TEST_CASE("ring_buffer and window objects")
+{
+    {
+        tcb::ring_buffer<int> buf(3);
+        CHECK(buf.capacity() == 4u);
+        CHECK(buf.empty());
+        for (int i = 0; i < 10; ++i) {
+            buf.push_back(i);
+            if (buf.size() == 3) {
+                CHECK(buf.front() == i - 2);
+                CHECK(buf.back() == i);
+                CHECK(buf[1] == i - 1);
+                buf.pop_front();
+            }
+        }
+        buf.pop_back();
+        CHECK(buf.size() == 1u);
+        CHECK(buf.back() == 8);
+        buf.reset(2);
+        CHECK(buf.capacity() == 4u);
+        CHECK(buf.empty());
+    }
+
+    // windows can be reset and reused without reallocation
+    {
+        tcb::monotonic_window<int> mw(3);
+        tcb::two_stacks_window<int, std::plus<>> tw(3);
+        for (int rep = 0; rep < 2; ++rep) {
+            mw.reset();
+            tw.reset();
+            for (int x : {5, 3, 8, 6, 7}) {
+                mw.push(x);
+                tw.push(x);
+            }
+            CHECK(mw.count() == 5);
+            CHECK(mw.value() == 6);
+            CHECK(tw.value() == 21);
+        }
+    }
+
+    // elements are constructed and destroyed as they are pushed and popped,
+    // so the value type need not be default constructible
+    {
+        {
+            tcb::ring_buffer<counted> buf(4);
+            CHECK(counted::live == 0);
+            for (int i = 0; i < 6; ++i) {
+                buf.push_back(counted(i));
+                if (buf.size() == 3) {
+                    buf.pop_front();
+                }
+            }
+            CHECK(counted::live == 2);
+            CHECK(buf.front().value == 4);
+
+            tcb::ring_buffer<counted> moved(std::move(buf));
+            CHECK(counted::live == 2);
+            CHECK(moved.back().value == 5);
+            moved.reset(8);
+            CHECK(counted::live == 0);
+            moved.push_back(counted(1));
+        }
+        CHECK(counted::live == 0);
+
+        std::vector<counted> in;
+        for (int x : {5, 3, 8, 6, 7}) {
+            in.emplace_back(x);
+        }
+        std::vector<counted> sums;
+        std::vector<counted> mins;
+        tcb::moving_reduce(in, 3, std::back_inserter(sums), std::plus<>{});
+        tcb::moving_min(in, 3, std::back_inserter(mins), std::less<>{});
+        REQUIRE(sums.size() == 3u);
+        REQUIRE(mins.size() == 3u);
+        CHECK(sums[0].value == 16);
+        CHECK(sums[1].value == 17);
+        CHECK(sums[2].value == 21);
+        CHECK(mins[0].value == 3);
+        CHECK(mins[1].value == 3);
+        CHECK(mins[2].value == 6);
+    }
+}
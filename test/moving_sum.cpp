@@ -0,0 +1,193 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+#include "test_iterators.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+struct S {
+    int i;
+};
+
+template <class InIter, class OutIter, class InSent = InIter>
+void test()
+{
+    using tcb::moving_sum;
+    using tcb::rng::subrange;
+
+    int ia[] = {1, 2, 3, 4, 5, 6};
+    const unsigned s = sizeof(ia) / sizeof(ia[0]);
+
+    { // iterator
+        int ir[] = {6, 9, 12, 15};
+        int ib[s] = {0};
+        auto r = moving_sum(InIter(ia), InSent(ia + s), 3, OutIter(ib));
+        CHECK(base(r.in) == ia + s);
+        CHECK(base(r.out) == ib + 4);
+        for (unsigned i = 0; i < 4; ++i) { CHECK(ib[i] == ir[i]); }
+    }
+
+    { // range + output iterator
+        int ir[] = {6, 9, 12, 15};
+        int ib[s] = {0};
+        auto rng = subrange(InIter(ia), InSent(ia + s));
+        auto r = moving_sum(rng, 3, OutIter(ib));
+        CHECK(base(r.in) == ia + s);
+        CHECK(base(r.out) == ib + 4);
+        for (unsigned i = 0; i < 4; ++i) { CHECK(ib[i] == ir[i]); }
+    }
+
+    { // window of one is a copy
+        int ib[s] = {0};
+        auto r = moving_sum(InIter(ia), InSent(ia + s), 1, OutIter(ib));
+        CHECK(base(r.out) == ib + s);
+        for (unsigned i = 0; i < s; ++i) { CHECK(ib[i] == ia[i]); }
+    }
+
+    { // window covering the whole range
+        int ib[s] = {0};
+        auto r = moving_sum(InIter(ia), InSent(ia + s), s, OutIter(ib));
+        CHECK(base(r.out) == ib + 1);
+        CHECK(ib[0] == 21);
+    }
+
+    { // window longer than the range
+        int ib[s] = {0};
+        auto r = moving_sum(InIter(ia), InSent(ia + s), s + 1, OutIter(ib));
+        CHECK(base(r.in) == ia + s);
+        CHECK(base(r.out) == ib);
+    }
+
+    { // empty range
+        int ib[s] = {0};
+        auto r = moving_sum(InIter(ia), InSent(ia), 2, OutIter(ib));
+        CHECK(base(r.in) == ia);
+        CHECK(base(r.out) == ib);
+    }
+}
+
+template <typename T>
+void test_contiguous()
+{
+    for (std::ptrdiff_t n : {0, 1, 5, 100, 3000}) {
+        std::vector<T> in;
+        for (std::ptrdiff_t i = 0; i < n; ++i) {
+            in.push_back(static_cast<T>((i * 31) % 17) - T(8));
+        }
+
+        for (std::ptrdiff_t w : {1, 2, 7, 64, 1000}) {
+            std::vector<T> ref(in.size());
+            auto rr = tcb::moving_sum(ForwardIterator<const T*>(in.data()),
+                                      ForwardIterator<const T*>(in.data() + n),
+                                      w, ref.data());
+            ref.resize(rr.out - ref.data());
+
+            std::vector<T> out(in.size());
+            auto r = tcb::moving_sum(in, w, out.data());
+            CHECK(r.in == in.end());
+            CHECK(r.out - out.data() == static_cast<std::ptrdiff_t>(ref.size()));
+            out.resize(ref.size());
+            CHECK(out == ref);
+
+            std::vector<T> view_out;
+            for (T x : in | tcb::views::sliding_sum(w)) {
+                view_out.push_back(x);
+            }
+            CHECK(view_out == ref);
+        }
+    }
+}
+
+}
+
+TEST_CASE("moving_sum")
+{
+    test<ForwardIterator<const int*>, ForwardIterator<int*> >();
+    test<ForwardIterator<const int*>, BidirectionalIterator<int*> >();
+    test<ForwardIterator<const int*>, RandomAccessIterator<int*> >();
+    test<ForwardIterator<const int*>, int*>();
+
+    test<BidirectionalIterator<const int*>, int*>();
+
+    test<RandomAccessIterator<const int*>, int*>();
+
+    test<const int*, ForwardIterator<int*> >();
+    test<const int*, int*>();
+
+    test<ForwardIterator<const int*>, int*, Sentinel<const int*>>();
+    test<RandomAccessIterator<const int*>, int*, Sentinel<const int*>>();
+
+    test_contiguous<std::int8_t>();
+    test_contiguous<int>();
+    test_contiguous<long long>();
+    test_contiguous<float>();
+    test_contiguous<double>();
+
+    { // projections and custom ops
+        S sa[] = {{1}, {2}, {3}, {4}};
+        int ib[3] = {0};
+        tcb::moving_sum(sa, 2, ib, std::multiplies<>{}, std::divides<>{}, &S::i);
+        CHECK(ib[0] == 2);
+        CHECK(ib[1] == 6);
+        CHECK(ib[2] == 12);
+    }
+}
+
+TEST_CASE("views::sliding_sum")
+{
+    int ia[] = {1, 2, 3, 4, 5, 6};
+
+    {
+        auto v = tcb::views::sliding_sum(ia, 2);
+        CHECK(v.size() == 5u);
+        CHECK(tcb::rng::equal(v, std::vector<int>{3, 5, 7, 9, 11}));
+        // begin() is cached and may be called again
+        CHECK(tcb::rng::equal(v, std::vector<int>{3, 5, 7, 9, 11}));
+    }
+
+    {
+        auto v = ia | tcb::views::sliding_sum(4);
+        CHECK(v.size() == 3u);
+        CHECK(tcb::rng::equal(v, std::vector<int>{10, 14, 18}));
+    }
+
+    {
+        auto v = ia | tcb::views::sliding_sum(7);
+        CHECK(v.empty());
+        CHECK(v.size() == 0u);
+    }
+
+    {
+        double da[] = {1.0, 2.0, 4.0, 8.0, 16.0};
+        auto v = da | tcb::views::sliding_sum(2, std::multiplies<>{}, std::divides<>{});
+        CHECK(tcb::rng::equal(v, std::vector<double>{2.0, 8.0, 32.0, 128.0}));
+    }
+
+    { // copies of the view don't share the cached begin()
+        auto v = ia | tcb::views::sliding_sum(3);
+        auto w = v;
+        CHECK(*v.begin() == 6);
+        CHECK(*w.begin() == 6);
+        ia[0] = 10;
+        auto u = w;
+        CHECK(*u.begin() == 15);
+        ia[0] = 1;
+    }
+
+    // with a non-common, non-sized base
+    {
+        auto rng = tcb::rng::subrange(ForwardIterator<const int*>(ia),
+                                      Sentinel<const int*>(ia + 6));
+        auto v = rng | tcb::views::sliding_sum(3);
+        static_assert(tcb::rng::forward_range<decltype(v)>);
+        CHECK(tcb::rng::equal(v, std::vector<int>{6, 9, 12, 15}));
+    }
+}
@@ -0,0 +1,162 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include <numeric_ranges/parse_numbers.hpp>
+#include "catch.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+#include <cstdio>
+#include <unistd.h>
+#endif
+
+namespace {
+
+template <typename T, typename R>
+std::vector<T> to_vector(R&& r)
+{
+    std::vector<T> out;
+    for (auto&& v : r) {
+        out.push_back(v);
+    }
+    return out;
+}
+
+template <typename T>
+std::vector<T> parse(const std::string& text, char delim = ',',
+                     std::size_t block_size = 1 << 18)
+{
+    std::istringstream is(text);
+    return to_vector<T>(tcb::views::parse_numbers<T>(is, delim, block_size));
+}
+
+}
+
+TEST_CASE("parse_numbers parses delimited integers")
+{
+    REQUIRE(parse<int>("1,2,3") == std::vector<int>{1, 2, 3});
+    REQUIRE(parse<int>("1,2,3\n4,5,6\n") == std::vector<int>{1, 2, 3, 4, 5, 6});
+    REQUIRE(parse<int>(" 1 ,\t-2 ,3 \r\n") == std::vector<int>{1, -2, 3});
+    REQUIRE(parse<int>("1;2;;3", ';') == std::vector<int>{1, 2, 3});
+    REQUIRE(parse<int>("").empty());
+    REQUIRE(parse<int>("\n\n,").empty());
+}
+
+TEST_CASE("parse_numbers handles long and extreme integers")
+{
+    using i64 = std::int64_t;
+    using u64 = std::uint64_t;
+    constexpr auto imin = std::numeric_limits<i64>::min();
+    constexpr auto imax = std::numeric_limits<i64>::max();
+    constexpr auto umax = std::numeric_limits<u64>::max();
+
+    REQUIRE(parse<i64>("12345678,123456789012,-123456789012345678,0") ==
+            std::vector<i64>{12345678, 123456789012, -123456789012345678, 0});
+    REQUIRE(parse<i64>(std::to_string(imin) + "," + std::to_string(imax)) ==
+            std::vector<i64>{imin, imax});
+    REQUIRE(parse<u64>(std::to_string(umax) + "\n00000000000000000042") ==
+            std::vector<u64>{umax, 42});
+    REQUIRE(parse<std::int16_t>("-32768,32767") ==
+            std::vector<std::int16_t>{-32768, 32767});
+
+    // Every digit count, so each combination of whole and partial
+    // eight-digit groups is covered
+    i64 v = 0;
+    std::string text;
+    std::vector<i64> expected;
+    for (int digits = 1; digits <= 18; ++digits) {
+        v = v * 10 + (digits % 10);
+        text += std::to_string(v) + "," + std::to_string(-v) + "\n";
+        expected.push_back(v);
+        expected.push_back(-v);
+    }
+    REQUIRE(parse<i64>(text) == expected);
+}
+
+TEST_CASE("parse_numbers parses floating point values")
+{
+    const auto vec = parse<double>("1.5, -2.25e2,3\n1e-3\n");
+    REQUIRE(vec == std::vector<double>{1.5, -225.0, 3.0, 0.001});
+
+    const auto fvec = parse<float>("0.1 0.2", ' ');
+    REQUIRE(fvec == std::vector<float>{0.1f, 0.2f});
+}
+
+TEST_CASE("parse_numbers handles values split across blocks")
+{
+    std::string text;
+    std::vector<std::int64_t> expected;
+    for (std::int64_t i = 0; i < 5000; ++i) {
+        const auto v = (i * 7919) % 1000003 - 500000;
+        text += std::to_string(v);
+        text += (i % 10 == 9) ? "\n" : ",";
+        expected.push_back(v);
+    }
+
+    // Small blocks put block boundaries in the middle of many values, and
+    // a block smaller than a value forces the buffer to grow
+    for (std::size_t block : {1, 3, 7, 64, 4096}) {
+        REQUIRE(parse<std::int64_t>(text, ',', block) == expected);
+    }
+
+    std::istringstream is(text);
+    REQUIRE(tcb::accumulate(tcb::views::parse_numbers<std::int64_t>(is), std::int64_t{0}) ==
+            tcb::accumulate(expected, std::int64_t{0}));
+}
+
+TEST_CASE("parse_numbers stops at malformed input")
+{
+    std::istringstream is("1,2,x,4");
+    auto nums = tcb::views::parse_numbers<int>(is);
+    REQUIRE(to_vector<int>(nums) == std::vector<int>{1, 2});
+    REQUIRE(nums.failed());
+
+    for (const char* bad : {"1,2a,3", "1,1.5", "1,-", "1,99999999999"}) {
+        std::istringstream in(bad);
+        auto r = tcb::views::parse_numbers<int>(in);
+        REQUIRE(to_vector<int>(r) == std::vector<int>{1});
+        REQUIRE(r.failed());
+    }
+
+    std::istringstream good("1,2\n");
+    auto r = tcb::views::parse_numbers<unsigned>(good);
+    REQUIRE(to_vector<unsigned>(r) == std::vector<unsigned>{1, 2});
+    REQUIRE(!r.failed());
+
+    std::istringstream neg("-1");
+    auto u = tcb::views::parse_numbers<unsigned>(neg);
+    REQUIRE(to_vector<unsigned>(u).empty());
+    REQUIRE(u.failed());
+}
+
+#if __has_include(<unistd.h>)
+
+TEST_CASE("parse_numbers reads from file descriptors")
+{
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+    const std::string text = "1.5,2.5\n3\n";
+    REQUIRE(::write(fds[1], text.data(), text.size()) ==
+            static_cast<ssize_t>(text.size()));
+    ::close(fds[1]);
+
+    auto nums = tcb::views::parse_numbers<double>(fds[0]);
+    REQUIRE(tcb::accumulate(nums, 0.0) == 7.0);
+    REQUIRE(!nums.failed());
+    ::close(fds[0]);
+
+    auto bad = tcb::views::parse_numbers<double>(-1);
+    REQUIRE(bad.begin() == bad.end());
+    REQUIRE(bad.failed());
+}
+
+#endif
@@ -0,0 +1,91 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace rng = tcb::rng;
+
+TEST_CASE("views::prefetch yields the elements of its base")
+{
+    std::vector<int> vec;
+    for (int i = 0; i < 100; ++i) {
+        vec.push_back(i * 3 - 50);
+    }
+
+    for (std::ptrdiff_t d : {-1, 0, 1, 16, 99, 100, 1000}) {
+        auto pf = tcb::views::prefetch(vec, d);
+        REQUIRE(pf.distance() == d);
+        REQUIRE(pf.size() == vec.size());
+
+        std::vector<int> out;
+        for (int i : pf) {
+            out.push_back(i);
+        }
+        REQUIRE(out == vec);
+
+        REQUIRE(tcb::accumulate(vec | tcb::views::prefetch(d), 0) ==
+                tcb::accumulate(vec, 0));
+    }
+}
+
+TEST_CASE("views::prefetch yields references to the base elements")
+{
+    int arr[] = {1, 2, 3, 4, 5};
+    for (int& i : tcb::views::prefetch(arr, 2)) {
+        i *= 10;
+    }
+    REQUIRE(arr[0] == 10);
+    REQUIRE(arr[4] == 50);
+
+    auto pf = arr | tcb::views::prefetch(1);
+    auto it = pf.begin();
+    REQUIRE(it.base() == arr);
+    REQUIRE(&*it == arr);
+    it++;
+    REQUIRE(*it == 20);
+}
+
+TEST_CASE("views::prefetch with an empty range")
+{
+    std::vector<double> empty;
+    auto pf = tcb::views::prefetch(empty, 8);
+    REQUIRE(pf.begin() == pf.end());
+    REQUIRE(tcb::accumulate(pf, 1.5) == 1.5);
+}
+
+TEST_CASE("views::prefetch of gathered elements")
+{
+    std::vector<std::uint64_t> table;
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+        table.push_back(i * i);
+    }
+
+    std::vector<std::uint32_t> idx;
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        idx.push_back((i * 367) % 1000);
+    }
+
+    const auto lookup = [&table](std::uint32_t i) { return table[i]; };
+    const auto address = [&table](std::uint32_t i) { return &table[i]; };
+
+    std::uint64_t expected = 0;
+    for (auto i : idx) {
+        expected += table[i];
+    }
+
+    auto r = idx | tcb::views::prefetch(16, address) | rng::views::transform(lookup);
+    REQUIRE(tcb::accumulate(r, std::uint64_t{0}) == expected);
+
+    // Strided views of lvalues can use the default address
+    auto rev = table | rng::views::reverse | tcb::views::prefetch(4);
+    REQUIRE(*rev.begin() == table.back());
+    REQUIRE(tcb::accumulate(rev, std::uint64_t{0}) ==
+            tcb::accumulate(table, std::uint64_t{0}));
+}
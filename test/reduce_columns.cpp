@@ -0,0 +1,132 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename T>
+std::vector<T> make_matrix(std::size_t rows, std::size_t cols)
+{
+    std::vector<T> vec;
+    for (std::size_t i = 0; i < rows * cols; ++i) {
+        vec.push_back(static_cast<T>(static_cast<int>(i * 37 % 101) - 50) / T(4));
+    }
+    return vec;
+}
+
+}
+
+TEST_CASE("reduce_columns sums each column")
+{
+    for (std::size_t cols : {1, 3, 17, 600, 1500}) {
+        const std::size_t rows = 50;
+        const auto data = make_matrix<double>(rows, cols);
+        const tcb::matrix_view<const double> m(data.data(), rows, cols);
+
+        std::vector<double> out(cols);
+        const auto end = tcb::reduce_columns(m, out.begin(), 1.0);
+        REQUIRE(end == out.end());
+        for (std::size_t j = 0; j < cols; ++j) {
+            // Each column is summed in order, so exactly
+            REQUIRE(out[j] == tcb::accumulate(m.column(j), 1.0));
+        }
+    }
+}
+
+TEST_CASE("reduce_columns of a block of a larger matrix")
+{
+    const auto data = make_matrix<float>(30, 20);
+    const tcb::matrix_view<const float> m(data.data() + 20 * 5 + 3, 10, 12, 20);
+
+    std::vector<double> out;
+    tcb::reduce_columns(m, std::back_inserter(out), 0.0);
+    REQUIRE(out.size() == 12);
+    for (std::size_t j = 0; j < 12; ++j) {
+        REQUIRE(out[j] == tcb::accumulate(m.column(j), 0.0));
+    }
+}
+
+TEST_CASE("reduce_columns of integers wraps like accumulate's fast path")
+{
+    const std::vector<std::int32_t> data{INT32_MAX, 1, 1, 2};
+    const tcb::matrix_view<const std::int32_t> m(data.data(), 2, 2);
+
+    std::int32_t out[2] = {};
+    tcb::reduce_columns(m, out);
+    REQUIRE(out[0] == INT32_MIN);
+    REQUIRE(out[1] == 3);
+
+    std::int64_t wide[2] = {};
+    tcb::reduce_columns(m, wide, std::int64_t{0});
+    REQUIRE(wide[0] == std::int64_t{INT32_MAX} + 1);
+}
+
+TEST_CASE("reduce_columns of floating-point elements into an integer matches accumulate")
+{
+    // One column {2.5, -1.5, 0}: accumulate adds each element to the running
+    // int, rather than truncating each element first
+    const double data[] = {2.5, 1.0,
+                           -1.5, 1.0,
+                           0.0, 1.0};
+    const tcb::matrix_view<const double> m(data, 3, 2);
+
+    int out[2] = {};
+    tcb::reduce_columns(m, out, 0);
+    REQUIRE(out[0] == tcb::accumulate(m.column(0), 0));
+    REQUIRE(out[0] == 0);
+    REQUIRE(out[1] == 3);
+
+    // Doubles into a float sum are rounded once, as by accumulate: rounding
+    // 2^-24 + 2^-50 to float first would leave 1 + 2^-24 a tie, rounded down
+    const double fine[] = {std::ldexp(1.0, -24) + std::ldexp(1.0, -50)};
+    const tcb::matrix_view<const double> col(fine, 1, 1);
+    float f = 0;
+    tcb::reduce_columns(col, &f, 1.0f);
+    REQUIRE(f == tcb::accumulate(col.column(0), 1.0f));
+    REQUIRE(f > 1.0f);
+}
+
+TEST_CASE("reduce_columns with other operations and projections")
+{
+    const int data[] = {1, 2, 3,
+                        4, 5, 6};
+    const tcb::matrix_view<const int> m(data, 2, 3);
+
+    int prod[3] = {};
+    tcb::reduce_columns(m, prod, 1, std::multiplies<>{});
+    REQUIRE(prod[0] == 4);
+    REQUIRE(prod[2] == 18);
+
+    int squares[3] = {};
+    tcb::reduce_columns(m, squares, 0, std::plus<>{}, [](int x) { return x * x; });
+    REQUIRE(squares[1] == 29);
+
+    std::vector<std::string> names;
+    tcb::reduce_columns(m, std::back_inserter(names), std::string("#"), std::plus<>{},
+                        [](int x) { return std::to_string(x); });
+    REQUIRE(names == std::vector<std::string>{"#14", "#25", "#36"});
+}
+
+TEST_CASE("reduce_columns of an empty matrix")
+{
+    const double* none = nullptr;
+    double out[4] = {9, 9, 9, 9};
+
+    // No rows: each column reduces to init
+    REQUIRE(tcb::reduce_columns(tcb::matrix_view<const double>(none, 0, 4, 4), out, 2.0) == out + 4);
+    REQUIRE(out[3] == 2.0);
+
+    // No columns: nothing is written
+    REQUIRE(tcb::reduce_columns(tcb::matrix_view<const double>(none, 5, 0), out) == out);
+}
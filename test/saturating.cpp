@@ -0,0 +1,177 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+#include "test_iterators.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <vector>
+
+namespace {
+
+template <typename T>
+constexpr T max_of = (std::numeric_limits<T>::max)();
+
+template <typename T>
+constexpr T min_of = (std::numeric_limits<T>::min)();
+
+// Clamps x + y into T, the slow way
+template <typename T>
+T clamped_sum(long long x, long long y)
+{
+    if (y > 0 && x > max_of<T> - y) {
+        return max_of<T>;
+    }
+    if (y < 0 && x < min_of<T> - y) {
+        return min_of<T>;
+    }
+    return static_cast<T>(x + y);
+}
+
+// Samples which drift up for a while and then down, far enough to reach
+// both bounds of T, so that some blocks saturate and others do not
+template <typename T>
+std::vector<T> make_signal(std::size_t n)
+{
+    const long long step = max_of<T> / 64 + 1;
+    std::vector<T> v(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const long long noise = static_cast<long long>((i * 37) % 19) - 9;
+        const long long drift = (i / 3000) % 2 == 0 ? step : -step;
+        v[i] = clamped_sum<T>(noise * step / 8, std::is_signed_v<T> ? drift : step / 2);
+    }
+    return v;
+}
+
+template <typename T, typename Acc>
+void test_saturating_accumulate()
+{
+    for (std::size_t n : {0, 1, 15, 16, 17, 255, 256, 1000, 4096, 4097, 20000}) {
+        const auto v = make_signal<T>(n);
+
+        for (Acc init : {Acc(0), max_of<Acc>, min_of<Acc>, Acc(max_of<Acc> - 3)}) {
+            Acc expected = init;
+            for (T x : v) {
+                expected = clamped_sum<Acc>(expected, x);
+            }
+            CHECK(tcb::accumulate(v, init, tcb::saturating_plus<>{}) == expected);
+            CHECK(tcb::reduce(v.begin(), v.end(), init, tcb::saturating_plus<Acc>{}) == expected);
+        }
+    }
+}
+
+template <typename T>
+void test_saturating_scans()
+{
+    for (std::size_t n : {0, 1, 15, 16, 17, 255, 256, 257, 1000, 20000}) {
+        const auto v = make_signal<T>(n);
+
+        std::vector<T> sums(n), diffs(n);
+        T sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sum = clamped_sum<T>(sum, v[i]);
+            sums[i] = sum;
+            diffs[i] = i == 0 ? v[0] : clamped_sum<T>(v[i], -static_cast<long long>(v[i - 1]));
+        }
+
+        std::vector<T> out(n);
+        tcb::partial_sum(v, out.begin(), tcb::saturating_plus<>{});
+        CHECK(out == sums);
+        auto in_place = v;
+        tcb::partial_sum(in_place, in_place.begin(), tcb::saturating_plus<T>{});
+        CHECK(in_place == sums);
+
+        tcb::adjacent_difference(v, out.begin(), tcb::saturating_minus<>{});
+        CHECK(out == diffs);
+        in_place = v;
+        tcb::adjacent_difference(in_place, in_place.begin(), tcb::saturating_minus<T>{});
+        CHECK(in_place == diffs);
+
+        // The running sums difference back to the samples wherever they did
+        // not saturate
+        tcb::adjacent_difference(sums, out.begin(), tcb::saturating_minus<>{});
+        for (std::size_t i = 0; i < n; ++i) {
+            if (sums[i] != max_of<T> && sums[i] != min_of<T> &&
+                (i == 0 || (sums[i - 1] != max_of<T> && sums[i - 1] != min_of<T>))) {
+                CHECK(out[i] == v[i]);
+            }
+        }
+    }
+}
+
+}
+
+TEST_CASE("saturating_plus and saturating_minus")
+{
+    CHECK(tcb::saturating_plus<std::int8_t>{}(100, 100) == 127);
+    CHECK(tcb::saturating_plus<std::int8_t>{}(-100, -100) == -128);
+    CHECK(tcb::saturating_plus<std::int8_t>{}(-100, 100) == 0);
+    CHECK(tcb::saturating_plus<std::uint8_t>{}(200, 100) == 255);
+    CHECK(tcb::saturating_minus<std::uint8_t>{}(3, 5) == 0);
+    CHECK(tcb::saturating_minus<std::int16_t>{}(-30000, 30000) == -32768);
+    CHECK(tcb::saturating_minus<std::int16_t>{}(30000, -30000) == 32767);
+    CHECK(tcb::saturating_plus<std::uint16_t>{}(65000, 535) == 65535);
+
+    CHECK(tcb::saturating_plus<int>{}(max_of<int>, 1) == max_of<int>);
+    CHECK(tcb::saturating_plus<int>{}(min_of<int>, -1) == min_of<int>);
+    CHECK(tcb::saturating_plus<int>{}(min_of<int>, max_of<int>) == -1);
+    CHECK(tcb::saturating_minus<int>{}(min_of<int>, 1) == min_of<int>);
+    CHECK(tcb::saturating_minus<int>{}(0, min_of<int>) == max_of<int>);
+    CHECK(tcb::saturating_minus<int>{}(-1, min_of<int>) == max_of<int>);
+    CHECK(tcb::saturating_minus<unsigned>{}(3u, 5u) == 0u);
+    CHECK(tcb::saturating_plus<std::uint64_t>{}(max_of<std::uint64_t>, 2) == max_of<std::uint64_t>);
+    CHECK(tcb::saturating_minus<std::int64_t>{}(max_of<std::int64_t>, -1) == max_of<std::int64_t>);
+
+    // The transparent forms compute in the common type
+    CHECK(tcb::saturating_plus<>{}(std::int8_t(100), std::int8_t(100)) == std::int8_t(127));
+    CHECK(tcb::saturating_plus<>{}(max_of<int>, 1L) == max_of<int> + 1L);
+    CHECK(tcb::saturating_minus<>{}(1u, 2) == 0u);
+}
+
+TEST_CASE("saturating accumulate")
+{
+    test_saturating_accumulate<std::int8_t, std::int8_t>();
+    test_saturating_accumulate<std::uint8_t, std::uint8_t>();
+    test_saturating_accumulate<std::int16_t, std::int16_t>();
+    test_saturating_accumulate<std::uint16_t, std::uint16_t>();
+    test_saturating_accumulate<std::int16_t, int>();
+    test_saturating_accumulate<std::int8_t, std::int64_t>();
+    test_saturating_accumulate<std::uint16_t, unsigned>();
+
+    // Other iterators and ops take the ordinary path
+    const std::list<std::int8_t> l = {100, 100, -50};
+    CHECK(tcb::accumulate(l, std::int8_t(0), tcb::saturating_plus<>{}) == 77);
+    const short s[] = {30000, 30000, -30000};
+    CHECK(tcb::accumulate(InputIterator<const short*>(s), Sentinel<const short*>(s + 3),
+                          short(0), tcb::saturating_plus<short>{}) == 2767);
+    CHECK(tcb::accumulate(s, short(0), tcb::saturating_minus<>{}) == -2768);
+}
+
+TEST_CASE("saturating partial_sum and adjacent_difference")
+{
+    test_saturating_scans<std::int8_t>();
+    test_saturating_scans<std::uint8_t>();
+    test_saturating_scans<std::int16_t>();
+    test_saturating_scans<std::uint16_t>();
+}
+
+TEST_CASE("saturating ops are constexpr")
+{
+    constexpr auto check = [] {
+        const std::int16_t a[] = {30000, 30000, -1, -30000};
+        std::int16_t sums[4] = {};
+        tcb::partial_sum(a, sums, tcb::saturating_plus<>{});
+        std::int16_t diffs[4] = {};
+        tcb::adjacent_difference(a, diffs, tcb::saturating_minus<>{});
+        return tcb::accumulate(a, std::int16_t(0), tcb::saturating_plus<>{}) == 2766 &&
+               sums[1] == 32767 && sums[3] == 2766 &&
+               diffs[2] == -30001 && diffs[3] == -29999;
+    };
+    static_assert(check());
+}
@@ -0,0 +1,323 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#ifndef TCB_NUMERIC_RANGES_USE_NANORANGE
+#include <ranges>
+#endif
+
+namespace {
+
+template <typename C>
+C make_input(int n)
+{
+    C c;
+    for (int i = 0; i < n; ++i) {
+        c.push_back(static_cast<typename C::value_type>((i * 37) % 101 - 50));
+    }
+    return c;
+}
+
+template <typename T>
+std::vector<T> to_vector(const std::deque<T>& d)
+{
+    return std::vector<T>(d.begin(), d.end());
+}
+
+// A sequence split into two arrays, whose iterators know the split
+struct two_arrays {
+    int front[5] = {1, 2, 3, 4, 5};
+    int back[3] = {6, 7, 8};
+
+    struct iterator {
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using reference = int&;
+        using pointer = int*;
+        using iterator_category = std::forward_iterator_tag;
+
+        two_arrays* parent = nullptr;
+        int pos = 0;
+
+        int& operator*() const { return pos < 5 ? parent->front[pos] : parent->back[pos - 5]; }
+        iterator& operator++() { ++pos; return *this; }
+        iterator operator++(int) { auto tmp = *this; ++pos; return tmp; }
+        friend bool operator==(const iterator& lhs, const iterator& rhs) { return lhs.pos == rhs.pos; }
+        friend bool operator!=(const iterator& lhs, const iterator& rhs) { return lhs.pos != rhs.pos; }
+    };
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, 8}; }
+
+    static inline int segments_visited = 0;
+};
+
+}
+
+namespace tcb {
+
+template <>
+struct segmented_iterator_traits<two_arrays::iterator> {
+    template <typename F>
+    static void for_each_segment(two_arrays::iterator first, two_arrays::iterator last, F&& f)
+    {
+        auto& p = *first.parent;
+        if (first.pos < 5) {
+            const int stop = last.pos < 5 ? last.pos : 5;
+            if (first.pos != stop) {
+                ++two_arrays::segments_visited;
+                f(p.front + first.pos, p.front + stop);
+            }
+        }
+        if (last.pos > 5) {
+            const int start = first.pos > 5 ? first.pos : 5;
+            if (start != last.pos) {
+                ++two_arrays::segments_visited;
+                f(p.back + (start - 5), p.back + (last.pos - 5));
+            }
+        }
+    }
+};
+
+}
+
+TEST_CASE("accumulate and reduce over a deque")
+{
+    const auto d = make_input<std::deque<int>>(10'000);
+    const auto v = to_vector(d);
+
+    REQUIRE(tcb::accumulate(d, 0) == tcb::accumulate(v, 0));
+    REQUIRE(tcb::accumulate(d.begin() + 123, d.end() - 45, 7L) ==
+            tcb::accumulate(v.begin() + 123, v.end() - 45, 7L));
+    REQUIRE(tcb::accumulate(d.begin() + 3, d.begin() + 9, 0) ==
+            tcb::accumulate(v.begin() + 3, v.begin() + 9, 0));
+    REQUIRE(tcb::accumulate(d.begin(), d.begin(), 5) == 5);
+
+    const auto dd = make_input<std::deque<double>>(10'000);
+    const std::vector<double> vd(dd.begin(), dd.end());
+    REQUIRE(tcb::reduce(dd, 0.0) == tcb::reduce(vd, 0.0));
+    REQUIRE(tcb::accumulate(dd, 0.0, std::plus<>{}, [](double x) { return x * x; }) ==
+            tcb::accumulate(vd, 0.0, std::plus<>{}, [](double x) { return x * x; }));
+
+    const std::deque<int> empty;
+    REQUIRE(tcb::accumulate(empty, 3) == 3);
+}
+
+TEST_CASE("inner_product over deques")
+{
+    const auto d1 = make_input<std::deque<double>>(5000);
+    const auto d2 = make_input<std::deque<double>>(5003);
+    const std::vector<double> v1(d1.begin(), d1.end());
+    const std::vector<double> v2(d2.begin(), d2.end());
+
+    const double expected = tcb::inner_product(v1, v2, 0.0);
+    REQUIRE(tcb::inner_product(d1, v2, 0.0) == expected);
+    REQUIRE(tcb::inner_product(v1, d2, 0.0) == expected);
+    REQUIRE(tcb::inner_product(d1, d2, 0.0) == expected);
+    REQUIRE(tcb::inner_product(d1.begin() + 10, d1.end(), v2.begin(), v2.end(), 0.0) ==
+            tcb::inner_product(v1.begin() + 10, v1.end(), v2.begin(), v2.end(), 0.0));
+    REQUIRE(tcb::transform_reduce(d1, d2, 0.0) == tcb::transform_reduce(v1, v2, 0.0));
+
+    // The shorter sequence bounds the result
+    const std::vector<double> shorter(v1.begin(), v1.begin() + 700);
+    REQUIRE(tcb::inner_product(d1, shorter, 1.0) ==
+            tcb::inner_product(shorter, v1, 1.0));
+}
+
+TEST_CASE("iota over a deque")
+{
+    std::deque<int> d(5000);
+    const auto res = tcb::iota(d, -100);
+    REQUIRE(res == d.end());
+    for (std::size_t i = 0; i < d.size(); ++i) {
+        REQUIRE(d[i] == static_cast<int>(i) - 100);
+    }
+
+    std::deque<double> dd(3000);
+    tcb::iota(dd.begin() + 1, dd.end(), 0.5);
+    REQUIRE(dd[0] == 0.0);
+    REQUIRE(dd[1] == 0.5);
+    REQUIRE(dd[2999] == 2998.5);
+}
+
+TEST_CASE("partial_sum and adjacent_difference over a deque")
+{
+    const auto d = make_input<std::deque<int>>(10'000);
+    const auto v = to_vector(d);
+
+    std::vector<int> expected(v.size());
+    tcb::partial_sum(v, expected.data());
+
+    std::vector<int> out(d.size());
+    const auto res = tcb::partial_sum(d, out.data());
+    REQUIRE(res.in == d.end());
+    REQUIRE(res.out == out.data() + out.size());
+    REQUIRE(out == expected);
+
+    std::deque<int> dout(d.size());
+    tcb::partial_sum(d, dout.begin());
+    REQUIRE(to_vector(dout) == expected);
+
+    std::vector<long> wide(d.size());
+    tcb::partial_sum(d, wide.begin(), std::plus<long>{});
+    REQUIRE(wide.back() == tcb::accumulate(v, 0L));
+
+    const auto dd = make_input<std::deque<double>>(10'000);
+    const std::vector<double> vd(dd.begin(), dd.end());
+    std::vector<double> dexpected(vd.size());
+    tcb::adjacent_difference(vd, dexpected.data());
+
+    std::vector<double> dout2(dd.size());
+    tcb::adjacent_difference(dd, dout2.data());
+    REQUIRE(dout2 == dexpected);
+
+    std::vector<double> dout3;
+    tcb::adjacent_difference(dd.begin(), dd.end(), std::back_inserter(dout3),
+                             [](double a, double b) { return a - b; });
+    REQUIRE(dout3 == dexpected);
+}
+
+#if defined(__GLIBCXX__)
+// An iterator whose members share the names of libstdc++'s deque iterator
+struct deque_lookalike_iterator {
+    int* _M_cur;
+    int* _M_first;
+    int* _M_last;
+    int** _M_node;
+};
+
+TEST_CASE("only deque iterators are treated as deque iterators")
+{
+    REQUIRE(tcb::detail::has_segmented_iterator_traits_v<std::deque<int>::iterator>);
+    REQUIRE(tcb::detail::has_segmented_iterator_traits_v<std::deque<double>::const_iterator>);
+    REQUIRE_FALSE(tcb::detail::has_segmented_iterator_traits_v<deque_lookalike_iterator>);
+}
+
+TEST_CASE("deques are visited a block at a time with libstdc++")
+{
+    using iter = std::deque<int>::iterator;
+    REQUIRE(tcb::detail::is_segmented_v<iter, iter>);
+    REQUIRE(tcb::detail::is_segmented_range_v<std::deque<int>&>);
+
+    std::deque<int> d;
+    for (int i = 0; i < 5000; ++i) {
+        d.push_back(i);
+    }
+    for (int i = 1; i <= 300; ++i) {
+        d.push_front(-i);
+    }
+
+    // The segments are contiguous, in order, and cover [first, last) exactly
+    auto check = [](iter first, iter last) {
+        int segments = 0;
+        auto it = first;
+        tcb::detail::for_each_segment(first, last, [&](int* p, int* q) {
+            REQUIRE(p < q);
+            for (; p != q; ++p, ++it) {
+                REQUIRE(p == std::addressof(*it));
+            }
+            ++segments;
+        });
+        REQUIRE(it == last);
+        return segments;
+    };
+
+    REQUIRE(check(d.begin(), d.end()) > 1);
+    REQUIRE(check(d.begin() + 17, d.end() - 1000) > 1);
+    REQUIRE(check(d.begin() + 3, d.begin() + 4) == 1);
+    REQUIRE(check(d.begin() + 3, d.begin() + 3) == 0);
+    REQUIRE(tcb::accumulate(d, 0LL) == 4999LL * 5000 / 2 - 300LL * 301 / 2);
+}
+#endif
+
+TEST_CASE("user-defined segmented iterators")
+{
+    two_arrays a;
+
+    two_arrays::segments_visited = 0;
+    REQUIRE(tcb::accumulate(a, 0) == 36);
+    REQUIRE(two_arrays::segments_visited == 2);
+
+    auto first = a.begin();
+    ++first;
+    ++first;
+    auto last = a.begin();
+    for (int i = 0; i < 4; ++i) {
+        ++last;
+    }
+    two_arrays::segments_visited = 0;
+    REQUIRE(tcb::accumulate(first, last, 0) == 3 + 4);
+    REQUIRE(two_arrays::segments_visited == 1);
+
+    int out[8] = {};
+    tcb::partial_sum(a, out);
+    REQUIRE(out[4] == 15);
+    REQUIRE(out[7] == 36);
+
+    tcb::iota(a, 10);
+    REQUIRE(a.front[0] == 10);
+    REQUIRE(a.back[2] == 17);
+}
+
+#ifndef TCB_NUMERIC_RANGES_USE_NANORANGE
+TEST_CASE("algorithms over a join of vectors")
+{
+    std::vector<std::vector<int>> chunks;
+    std::vector<int> flat;
+    for (int i = 0; i < 50; ++i) {
+        chunks.emplace_back();
+        for (int j = 0; j < i % 7; ++j) {
+            chunks.back().push_back(i * 10 + j);
+            flat.push_back(i * 10 + j);
+        }
+    }
+
+    auto joined = chunks | std::views::join;
+    REQUIRE(tcb::accumulate(joined, 0) == tcb::accumulate(flat, 0));
+    REQUIRE(tcb::inner_product(joined, flat, 0L) == tcb::inner_product(flat, flat, 0L));
+
+    std::vector<int> expected(flat.size());
+    tcb::partial_sum(flat, expected.data());
+    std::vector<int> out(flat.size());
+    const auto res = tcb::partial_sum(joined, out.data());
+    REQUIRE(res.out == out.data() + out.size());
+    REQUIRE(out == expected);
+
+    tcb::adjacent_difference(flat, expected.data());
+    tcb::adjacent_difference(joined, out.begin());
+    REQUIRE(out == expected);
+
+    tcb::iota(joined, 0);
+    int n = 0;
+    for (const auto& c : chunks) {
+        for (int x : c) {
+            REQUIRE(x == n++);
+        }
+    }
+
+    std::vector<std::vector<double>> empties(3);
+    REQUIRE(tcb::accumulate(empties | std::views::join, 1.5) == 1.5);
+}
+
+TEST_CASE("algorithms over a join with an owning base")
+{
+    // join_view::base() would copy the vector, so this is not segmented
+    auto joined = std::views::join(std::views::single(std::vector<int>(5)));
+    REQUIRE_FALSE(tcb::detail::is_segmented_range_v<decltype(joined)&>);
+
+    tcb::iota(joined, 1);
+    const std::vector<int> result(joined.begin(), joined.end());
+    REQUIRE(result == std::vector<int>{1, 2, 3, 4, 5});
+    REQUIRE(tcb::accumulate(joined, 0) == 15);
+}
+#endif
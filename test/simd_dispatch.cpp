@@ -0,0 +1,411 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Runs the test body once for each tier the CPU supports, restoring the
+// original selection afterwards
+template <typename F>
+void for_each_isa(F f)
+{
+    const auto original = tcb::active_simd_isa();
+    for (auto isa : {tcb::simd_isa::scalar, tcb::simd_isa::avx2, tcb::simd_isa::avx512}) {
+        if (isa > tcb::detected_simd_isa()) {
+            break;
+        }
+        REQUIRE(tcb::set_simd_isa(isa) == isa);
+        REQUIRE(tcb::active_simd_isa() == isa);
+        f();
+    }
+    tcb::set_simd_isa(original);
+}
+
+const std::size_t sizes[] = {0, 1, 2, 7, 8, 15, 16, 17, 31, 64, 100, 1023};
+
+template <typename T>
+std::vector<T> make_data(std::size_t n)
+{
+    std::vector<T> v;
+    for (std::size_t i = 0; i < n; ++i) {
+        v.push_back(static_cast<T>((i * 37) % 19) - T(9));
+    }
+    return v;
+}
+
+template <typename T>
+void test_sums()
+{
+    for (std::size_t n : sizes) {
+        const auto v = make_data<T>(n);
+        const auto w = make_data<T>(n + 3);
+        const T* p = v.data();
+        const T* q = w.data() + 3;
+
+        const T sum = std::accumulate(v.begin(), v.end(), T(5));
+        const T dot = std::inner_product(v.begin(), v.end(), q, T(5));
+
+        CHECK(tcb::accumulate(p, p + n, T(5)) == sum);
+        CHECK(tcb::reduce(p, p + n, T(5)) == sum);
+        CHECK(tcb::inner_product(p, p + n, q, q + n, T(5)) == dot);
+        CHECK(tcb::transform_reduce(p, p + n, q, q + n, T(5)) == dot);
+    }
+}
+
+template <typename T>
+void test_scans()
+{
+    for (std::size_t n : sizes) {
+        const auto v = make_data<T>(n);
+        const T* p = v.data();
+
+        std::vector<T> expected(n), out(n + 1);
+        std::partial_sum(v.begin(), v.end(), expected.begin());
+        auto res = tcb::partial_sum(p, p + n, out.data());
+        CHECK(res.in == p + n);
+        CHECK(res.out == out.data() + n);
+        CHECK(std::equal(expected.begin(), expected.end(), out.begin()));
+
+        std::adjacent_difference(v.begin(), v.end(), expected.begin());
+        res = tcb::adjacent_difference(p, p + n, out.data());
+        CHECK(res.in == p + n);
+        CHECK(res.out == out.data() + n);
+        CHECK(std::equal(expected.begin(), expected.end(), out.begin()));
+
+        // in place
+        auto inplace = v;
+        std::partial_sum(v.begin(), v.end(), expected.begin());
+        tcb::partial_sum(inplace.data(), inplace.data() + n, inplace.data());
+        CHECK(inplace == expected);
+
+        inplace = v;
+        std::adjacent_difference(v.begin(), v.end(), expected.begin());
+        tcb::adjacent_difference(inplace.data(), inplace.data() + n, inplace.data());
+        CHECK(inplace == expected);
+
+        // overlapping, but not in place: takes the element-by-element path
+        if (n > 1) {
+            auto shifted = v;
+            shifted.push_back(T(0));
+            auto ref = shifted;
+            std::partial_sum(ref.begin(), ref.begin() + n, ref.begin() + 1);
+            tcb::partial_sum(shifted.data(), shifted.data() + n, shifted.data() + 1);
+            CHECK(shifted == ref);
+        }
+    }
+}
+
+template <typename T>
+void test_iota()
+{
+    for (std::size_t n : sizes) {
+        std::vector<T> expected(n), out(n);
+        std::iota(expected.begin(), expected.end(), T(-3));
+        CHECK(tcb::iota(out.data(), out.data() + n, T(-3)) == out.data() + n);
+        CHECK(out == expected);
+    }
+}
+
+}
+
+TEST_CASE("set_simd_isa clamps to the detected tier")
+{
+    const auto original = tcb::active_simd_isa();
+    CHECK(tcb::set_simd_isa(tcb::simd_isa::avx512) == tcb::detected_simd_isa());
+    CHECK(tcb::active_simd_isa() == tcb::detected_simd_isa());
+    CHECK(tcb::set_simd_isa(tcb::simd_isa::scalar) == tcb::simd_isa::scalar);
+    tcb::set_simd_isa(original);
+}
+
+TEST_CASE("simd_isa names")
+{
+    using tcb::detail::parse_simd_isa;
+    CHECK(parse_simd_isa("scalar") == tcb::simd_isa::scalar);
+    CHECK(parse_simd_isa("avx2") == tcb::simd_isa::avx2);
+    CHECK(parse_simd_isa("avx512") == tcb::simd_isa::avx512);
+    CHECK_FALSE(parse_simd_isa("sse9"));
+    CHECK_FALSE(parse_simd_isa(""));
+    CHECK_FALSE(parse_simd_isa(nullptr));
+}
+
+TEST_CASE("dispatched kernels agree on every tier")
+{
+    for_each_isa([] {
+        test_sums<std::int8_t>();
+        test_sums<std::uint16_t>();
+        test_sums<int>();
+        test_sums<std::int64_t>();
+        // small integer values, so floating point sums are exact in any order
+        test_sums<float>();
+        test_sums<double>();
+
+        test_scans<std::int32_t>();
+        test_scans<std::uint32_t>();
+        test_scans<std::int64_t>();
+        test_scans<std::uint64_t>();
+        test_scans<std::int16_t>();
+        test_scans<float>();
+        test_scans<double>();
+
+        test_iota<int>();
+        test_iota<std::uint8_t>();
+        test_iota<std::int64_t>();
+    });
+}
+
+TEST_CASE("accumulate and inner_product keep floating-point order")
+{
+    // 1 + 2^24 rounds back to 2^24 in float, so the order of additions
+    // is observable
+    std::vector<float> v(64, 1.0f);
+    v[0] = 16777216.0f;
+
+    for_each_isa([&] {
+        const float* p = v.data();
+        CHECK(tcb::accumulate(p, p + v.size(), 0.0f) == 16777216.0f);
+        CHECK(tcb::inner_product(p, p + v.size(), p, p + v.size(), 0.0f) ==
+              std::inner_product(v.begin(), v.end(), v.begin(), 0.0f));
+    });
+}
+
+TEST_CASE("widening sums agree on every tier")
+{
+    for_each_isa([] {
+        for (std::size_t n : sizes) {
+            const auto f = make_data<float>(n);
+            const float* p = f.data();
+            const double fsum = std::accumulate(f.begin(), f.end(), 0.5);
+            const double fdot = std::inner_product(f.begin(), f.end(), f.begin(), 0.5,
+                std::plus<>{}, [](float x, float y) { return double(x) * double(y); });
+            CHECK(tcb::reduce(p, p + n, 0.5) == fsum);
+            CHECK(tcb::transform_reduce(p, p + n, p, p + n, 0.5) == fdot);
+
+            // large enough that an int or unsigned accumulator would wrap
+            std::vector<std::int32_t> i(n);
+            std::vector<std::uint32_t> u(n);
+            for (std::size_t k = 0; k < n; ++k) {
+                i[k] = (k % 3 == 0 ? -1 : 1) * (2'000'000'000 - static_cast<std::int32_t>(k));
+                u[k] = 4'000'000'000u + static_cast<std::uint32_t>(k);
+            }
+            const std::int64_t isum = std::accumulate(i.begin(), i.end(), std::int64_t(-7));
+            const std::uint64_t usum = std::accumulate(u.begin(), u.end(), std::uint64_t(7));
+            CHECK(tcb::accumulate(i.data(), i.data() + n, std::int64_t(-7)) == isum);
+            CHECK(tcb::reduce(i.data(), i.data() + n, std::int64_t(-7)) == isum);
+            CHECK(tcb::accumulate(u.data(), u.data() + n, std::uint64_t(7)) == usum);
+        }
+    });
+}
+
+TEST_CASE("inner products form each product as op2 does on every tier")
+{
+    for_each_isa([] {
+        for (std::size_t n : sizes) {
+            // unsigned * unsigned is formed in unsigned, and wraps, before
+            // it is added to a 64-bit init
+            const std::vector<std::uint32_t> u(n, 65536u);
+            const long long udot = std::inner_product(u.begin(), u.end(), u.begin(), 5LL);
+            CHECK(tcb::inner_product(u.data(), u.data() + n, u.data(), u.data() + n, 5LL) == udot);
+            CHECK(tcb::transform_reduce(u.data(), u.data() + n, u.data(), u.data() + n, 5LL) == udot);
+
+            // unsigned * int is formed in unsigned
+            const std::vector<unsigned> ones(n, 1u);
+            const std::vector<int> minus_ones(n, -1);
+            const long long mdot = std::inner_product(ones.begin(), ones.end(),
+                                                      minus_ones.begin(), 0LL);
+            CHECK(tcb::inner_product(ones, minus_ones, 0LL) == mdot);
+
+            // float * float is rounded to float before it is added to a
+            // double init. The products share an exponent range, so their
+            // sum is exact in double in any order.
+            std::vector<float> f(n);
+            for (std::size_t k = 0; k < n; ++k) {
+                f[k] = 1.1f + 0.1f * static_cast<float>(k % 3);
+            }
+            double fdot = 0.0;
+            for (float x : f) {
+                fdot += static_cast<double>(x * x);
+            }
+            CHECK(tcb::transform_reduce(f.data(), f.data() + n, f.data(), f.data() + n, 0.0) == fdot);
+        }
+    });
+}
+
+TEST_CASE("float products are rounded as op2 rounds them on every tier")
+{
+    for_each_isa([] {
+        for (std::size_t n : sizes) {
+            // Neither operand is an integer, so a product formed in double
+            // differs from the same product rounded to float. The products
+            // lie in [1, 4), so their float-rounded sum is exact in double in
+            // any order, and so is their exact sum for n <= 32. (The
+            // reference adds in double: libstdc++'s transform_reduce would
+            // otherwise add pairs of float products in float.)
+            std::vector<float> a(n);
+            std::vector<float> b(n);
+            for (std::size_t k = 0; k < n; ++k) {
+                a[k] = 1.1f + 0.1f * static_cast<float>(k % 3);
+                b[k] = 1.3f + 0.1f * static_cast<float>(k % 5);
+            }
+            const double expected = std::transform_reduce(a.begin(), a.end(), b.begin(), 0.0,
+                                                          std::plus<double>{}, std::multiplies<>{});
+            CHECK(tcb::transform_reduce(a, b, 0.0) == expected);
+            CHECK(tcb::transform_reduce(a, b, 0.0, std::plus<double>{}, std::multiplies<>{}) == expected);
+            CHECK(tcb::inner_product(a, b, 0.0) == expected);
+
+            if (n <= 32) {
+                const double wide = std::transform_reduce(a.begin(), a.end(), b.begin(), 0.0,
+                                                          std::plus<>{}, std::multiplies<double>{});
+                CHECK(tcb::inner_product(a, b, 0.0, std::plus<>{}, std::multiplies<double>{}) == wide);
+            }
+        }
+    });
+}
+
+#if defined(__SIZEOF_INT128__)
+TEST_CASE("64-bit integers sum exactly into 128 bits on every tier")
+{
+    using tcb::detail::int128_t;
+    using tcb::detail::uint128_t;
+
+    for_each_isa([] {
+        for (std::size_t n : sizes) {
+            std::vector<std::int64_t> s(n);
+            std::vector<std::uint64_t> u(n);
+            std::vector<std::int32_t> narrow(n);
+            for (std::size_t k = 0; k < n; ++k) {
+                // mostly near the limits, so that any 64-bit total would wrap
+                s[k] = k % 5 == 0 ? -(INT64_MAX - std::int64_t(k)) : INT64_MAX - std::int64_t(k);
+                u[k] = UINT64_MAX - k;
+                narrow[k] = k % 2 == 0 ? INT32_MIN : INT32_MAX;
+            }
+
+            int128_t sexpected = -3;
+            uint128_t uexpected = 3;
+            int128_t nexpected = 0;
+            for (std::size_t k = 0; k < n; ++k) {
+                sexpected += s[k];
+                uexpected += u[k];
+                nexpected += narrow[k];
+            }
+
+            CHECK(tcb::accumulate(s, int128_t(-3)) == sexpected);
+            CHECK(tcb::reduce(s, int128_t(-3)) == sexpected);
+            CHECK(tcb::accumulate(u, uint128_t(3)) == uexpected);
+            CHECK(tcb::accumulate(narrow, int128_t(0)) == nexpected);
+        }
+    });
+}
+#endif
+
+TEST_CASE("sparse-dense inner products agree on every tier")
+{
+    for_each_isa([] {
+        for (std::size_t n : sizes) {
+            const auto dense = make_data<std::int64_t>(3 * n + 1);
+            const auto fdense = make_data<double>(3 * n + 1);
+            std::vector<std::pair<std::uint32_t, std::int64_t>> sparse;
+            std::vector<std::pair<std::uint32_t, double>> fsparse;
+            std::int64_t expected = 7;
+            double fexpected = 0.5;
+            for (std::size_t k = 0; k < n; ++k) {
+                const auto idx = static_cast<std::uint32_t>((k * 5) % (3 * n + 1));
+                sparse.emplace_back(idx, std::int64_t(k % 11) - 5);
+                fsparse.emplace_back(idx, double(k % 11) - 5);
+                expected += sparse.back().second * dense[idx];
+                fexpected += fsparse.back().second * fdense[idx];
+            }
+            CHECK(tcb::sparse_inner_product(sparse, dense, std::int64_t(7)) == expected);
+            // small integers, so every order of summation is exact
+            CHECK(tcb::sparse_inner_product(fsparse, fdense, 0.5) == fexpected);
+
+            // unsigned products wrap in 32 bits, as in the dense inner_product
+            const std::vector<std::uint32_t> udense(3 * n + 1, 65536u);
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> usparse;
+            std::vector<std::uint32_t> uvalues;
+            std::vector<std::uint32_t> ugathered;
+            for (std::size_t k = 0; k < n; ++k) {
+                const auto idx = static_cast<std::uint32_t>((k * 5) % (3 * n + 1));
+                usparse.emplace_back(idx, 65536u + static_cast<std::uint32_t>(k % 3));
+                uvalues.push_back(usparse.back().second);
+                ugathered.push_back(udense[idx]);
+            }
+            CHECK(tcb::sparse_inner_product(usparse, udense, 5LL) ==
+                  tcb::inner_product(uvalues, ugathered, 5LL));
+            CHECK(tcb::sparse_inner_product(usparse, udense, 5LL) ==
+                  std::inner_product(uvalues.begin(), uvalues.end(), ugathered.begin(), 5LL));
+        }
+    });
+}
+
+TEST_CASE("checked sums agree on every tier")
+{
+    for_each_isa([] {
+        for (std::size_t n : sizes) {
+            std::vector<std::int32_t> a(n);
+            std::vector<std::uint32_t> b(n);
+            for (std::size_t k = 0; k < n; ++k) {
+                a[k] = k % 3 == 0 ? INT32_MIN + std::int32_t(k) : INT32_MAX - std::int32_t(k);
+                b[k] = UINT32_MAX - std::uint32_t(k);
+            }
+
+            // The exact results, from 128-bit arithmetic on wide_total
+            tcb::detail::wide_total sum, dot, udot;
+            for (std::size_t k = 0; k < n; ++k) {
+                sum.add(a[k]);
+                dot.add(std::int64_t(a[k]) * std::int64_t(a[k]));
+                udot.add(std::uint64_t(b[k]) * std::uint64_t(b[k]));
+            }
+
+            const auto r = tcb::checked_accumulate(a, std::int32_t(0));
+            CHECK(r.value == sum.result<std::int32_t>().value);
+            CHECK(r.overflowed == sum.result<std::int32_t>().overflowed);
+
+            const auto d = tcb::checked_inner_product(a, a, std::int64_t(0));
+            CHECK(d.value == dot.result<std::int64_t>().value);
+            CHECK(d.overflowed == (n > 2));
+
+            const auto u = tcb::checked_inner_product(b, b, std::uint64_t(0));
+            CHECK(u.value == udot.result<std::uint64_t>().value);
+            CHECK(u.overflowed == (n > 1));
+        }
+    });
+}
+
+TEST_CASE("saturating sums agree on every tier")
+{
+    for_each_isa([] {
+        for (std::size_t n : {std::size_t(0), std::size_t(17), std::size_t(1023), std::size_t(9000)}) {
+            // Long runs of one sign, so that some blocks saturate
+            std::vector<std::int16_t> v(n);
+            for (std::size_t k = 0; k < n; ++k) {
+                v[k] = static_cast<std::int16_t>((k / 700) % 2 == 0 ? 97 * (k % 11) : -113 * (k % 13));
+            }
+
+            std::int16_t sum = 0;
+            std::vector<std::int16_t> sums(n), diffs(n);
+            for (std::size_t k = 0; k < n; ++k) {
+                sum = tcb::saturating_plus<std::int16_t>{}(sum, v[k]);
+                sums[k] = sum;
+                diffs[k] = k == 0 ? v[0] : tcb::saturating_minus<std::int16_t>{}(v[k], v[k - 1]);
+            }
+
+            CHECK(tcb::accumulate(v, std::int16_t(0), tcb::saturating_plus<>{}) == sum);
+            std::vector<std::int16_t> out(n);
+            tcb::partial_sum(v, out.begin(), tcb::saturating_plus<>{});
+            CHECK(out == sums);
+            tcb::adjacent_difference(v, out.begin(), tcb::saturating_minus<>{});
+            CHECK(out == diffs);
+        }
+    });
+}
@@ -0,0 +1,160 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+#include "test_iterators.hpp"
+
+#include <cstdint>
+#include <forward_list>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct entry {
+    std::uint32_t index;
+    float value;
+};
+
+template <typename Idx, typename V, typename T>
+void test_sparse_dense(std::size_t nnz)
+{
+    std::vector<V> dense;
+    for (std::size_t i = 0; i < 3 * nnz + 1; ++i) {
+        dense.push_back(static_cast<V>(i % 11) - V(5));
+    }
+
+    std::vector<std::pair<Idx, V>> sparse;
+    for (std::size_t i = 0; i < nnz; ++i) {
+        sparse.emplace_back(static_cast<Idx>((i * 7) % dense.size()),
+                            static_cast<V>(i % 5));
+    }
+
+    T expected(2);
+    for (const auto& [i, v] : sparse) {
+        expected += static_cast<T>(v * dense[i]);
+    }
+
+    const auto* sp = sparse.data();
+    // small integer values, so exact even for floating point
+    CHECK(tcb::sparse_inner_product(sp, sp + sparse.size(), dense.data(), T(2)) == expected);
+    CHECK(tcb::sparse_inner_product(sparse, dense, T(2)) == expected);
+}
+
+}
+
+TEST_CASE("sparse_inner_product (sparse-dense)")
+{
+    for (std::size_t nnz : {0, 1, 7, 8, 16, 33, 1000}) {
+        test_sparse_dense<int, float, float>(nnz);
+        test_sparse_dense<std::size_t, double, double>(nnz);
+        test_sparse_dense<std::int32_t, float, double>(nnz);
+        test_sparse_dense<int, int, int>(nnz);
+        test_sparse_dense<short, std::int64_t, std::int64_t>(nnz);
+    }
+
+    // record type with member pointer projections
+    {
+        const entry sparse[] = {{0, 1.5f}, {3, 2.0f}, {4, -1.0f}};
+        const float dense[] = {2.0f, 100.0f, 100.0f, 4.0f, 8.0f};
+        CHECK(tcb::sparse_inner_product(sparse, dense, 0.0f,
+                                        std::plus<>{}, std::multiplies<>{},
+                                        &entry::index, &entry::value) == 3.0f);
+    }
+
+    // single-pass sparse input, dense projection and custom ops
+    {
+        std::forward_list<std::tuple<int, int>> sparse{{2, 3}, {0, 5}};
+        const std::pair<char, int> dense[] = {{'a', 1}, {'b', 2}, {'c', 4}};
+        const auto res = tcb::sparse_inner_product(
+            InputIterator<std::forward_list<std::tuple<int, int>>::const_iterator>(sparse.begin()),
+            Sentinel<std::forward_list<std::tuple<int, int>>::const_iterator>(sparse.end()),
+            dense, 1, std::multiplies<>{}, std::plus<>{},
+            tcb::detail::get_fn<0>{}, tcb::detail::get_fn<1>{},
+            &std::pair<char, int>::second);
+        CHECK(res == 42); // 1 * (3 + 4) * (5 + 1)
+    }
+
+    // integer init with floating-point values is summed as written, not
+    // truncated element by element
+    {
+        const std::pair<int, double> sparse[] = {{0, 1.5}, {1, 2.5}};
+        const int dense[] = {2, 2};
+        CHECK(tcb::sparse_inner_product(sparse, dense, 0L) == 8);
+
+        const std::pair<int, int> isparse[] = {{0, 3}, {1, 1}};
+        const double ddense[] = {0.5, -2.5};
+        CHECK(tcb::sparse_inner_product(isparse, ddense, 0L) == -1);
+    }
+}
+
+namespace {
+
+constexpr int constexpr_sparse_dense()
+{
+    const std::pair<int, int> sparse[] = {{1, 2}, {3, 3}};
+    const int dense[] = {10, 20, 30, 40};
+    return tcb::sparse_inner_product(sparse, dense, 0);
+}
+
+constexpr int constexpr_sparse_sparse()
+{
+    const std::pair<int, int> a[] = {{1, 2}, {3, 3}, {5, 1}};
+    const std::pair<int, int> b[] = {{0, 9}, {3, 4}, {5, 7}};
+    return tcb::sparse_sparse_inner_product(a, b, 0);
+}
+
+}
+
+TEST_CASE("sparse_inner_product is constexpr")
+{
+    static_assert(constexpr_sparse_dense() == 160);
+    static_assert(constexpr_sparse_sparse() == 19);
+}
+
+TEST_CASE("sparse_sparse_inner_product")
+{
+    const std::vector<std::pair<int, double>> a{
+        {0, 1.0}, {2, 2.0}, {3, 4.0}, {7, 8.0}, {9, 0.5}};
+    const std::vector<std::pair<int, double>> b{
+        {1, 3.0}, {2, 5.0}, {7, 2.0}, {8, 1.0}, {9, 6.0}, {12, 1.0}};
+
+    // matches at indices 2, 7 and 9
+    CHECK(tcb::sparse_sparse_inner_product(a, b, 0.0) == 29.0);
+    CHECK(tcb::sparse_sparse_inner_product(b, a, 0.0) == 29.0);
+    CHECK(tcb::sparse_sparse_inner_product(a, a, 0.0) == 85.25);
+    CHECK(tcb::sparse_sparse_inner_product(a.begin(), a.begin(), b.begin(), b.end(), 1.0) == 1.0);
+
+    // single-pass iterators take the branching merge
+    {
+        std::forward_list<entry> la{{1, 2.0f}, {4, 3.0f}, {6, 1.0f}};
+        std::forward_list<entry> lb{{4, 5.0f}, {5, 1.0f}, {6, 2.0f}, {10, 9.0f}};
+        const auto res = tcb::sparse_sparse_inner_product(
+            InputIterator<std::forward_list<entry>::iterator>(la.begin()),
+            Sentinel<std::forward_list<entry>::iterator>(la.end()),
+            InputIterator<std::forward_list<entry>::iterator>(lb.begin()),
+            Sentinel<std::forward_list<entry>::iterator>(lb.end()),
+            0.0f, std::plus<>{}, std::multiplies<>{},
+            &entry::index, &entry::value);
+        CHECK(res == 17.0f);
+    }
+
+    // random data checked against a dense computation
+    std::vector<std::pair<std::size_t, long>> x, y;
+    for (std::size_t i = 0; i < 500; ++i) {
+        if (i % 3 == 0) x.emplace_back(i, static_cast<long>(i % 17));
+        if (i % 5 == 1 || i % 7 == 0) y.emplace_back(i, static_cast<long>(i % 13) - 6);
+    }
+    long expected = 0;
+    for (const auto& [i, v] : x) {
+        for (const auto& [j, w] : y) {
+            if (i == j) expected += v * w;
+        }
+    }
+    CHECK(tcb::sparse_sparse_inner_product(x, y, 0L) == expected);
+}
@@ -0,0 +1,206 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+// Runs f once for each tier the CPU supports, since the vector tiers of
+// partial_sum write their streaming stores directly
+template <typename F>
+void for_each_isa(F f)
+{
+    const auto original = tcb::active_simd_isa();
+    for (auto isa : {tcb::simd_isa::scalar, tcb::simd_isa::avx2, tcb::simd_isa::avx512}) {
+        if (isa > tcb::detected_simd_isa()) {
+            break;
+        }
+        tcb::set_simd_isa(isa);
+        f();
+    }
+    tcb::set_simd_isa(original);
+}
+
+template <typename T>
+std::vector<T> make_input(std::size_t n)
+{
+    std::vector<T> vec;
+    for (std::size_t i = 0; i < n; ++i) {
+        vec.push_back(static_cast<T>((i * 37) % 101) - T(50));
+    }
+    return vec;
+}
+
+// Sizes around the staging block, at offsets which leave the output
+// unaligned for the non-temporal stores
+constexpr std::size_t sizes[] = {1, 3, 17, 1023, 1024, 1025, 4096, 10'001};
+constexpr std::size_t offsets[] = {0, 1, 3};
+
+template <typename T>
+void test_partial_sum()
+{
+    for (std::size_t n : sizes) {
+        for (std::size_t off : offsets) {
+            const auto in = make_input<T>(n);
+            std::vector<T> expected(n);
+            std::partial_sum(in.begin(), in.end(), expected.begin());
+
+            std::vector<T> out(n + off);
+            T* const dst = out.data() + off;
+            const auto res = tcb::partial_sum(in.data(), in.data() + n,
+                                              tcb::streaming_store(dst, 0));
+            REQUIRE(res.in == in.data() + n);
+            REQUIRE(res.out.base() == dst + n);
+            REQUIRE(std::vector<T>(dst, dst + n) == expected);
+
+            // In place
+            auto inout = in;
+            tcb::partial_sum(inout.data(), inout.data() + n,
+                             tcb::streaming_store(inout.data(), 0));
+            REQUIRE(inout == expected);
+        }
+    }
+}
+
+template <typename T>
+void test_adjacent_difference()
+{
+    for (std::size_t n : sizes) {
+        for (std::size_t off : offsets) {
+            const auto in = make_input<T>(n);
+            std::vector<T> expected(n);
+            std::adjacent_difference(in.begin(), in.end(), expected.begin());
+
+            std::vector<T> out(n + off);
+            T* const dst = out.data() + off;
+            const auto res = tcb::adjacent_difference(in.data(), in.data() + n,
+                                                      tcb::streaming_store(dst, 0));
+            REQUIRE(res.in == in.data() + n);
+            REQUIRE(res.out.base() == dst + n);
+            REQUIRE(std::vector<T>(dst, dst + n) == expected);
+
+            auto inout = in;
+            tcb::adjacent_difference(inout.data(), inout.data() + n,
+                                     tcb::streaming_store(inout.data(), 0));
+            REQUIRE(inout == expected);
+        }
+    }
+}
+
+template <typename T>
+void test_iota()
+{
+    for (std::size_t n : sizes) {
+        for (std::size_t off : offsets) {
+            std::vector<T> expected(n);
+            std::iota(expected.begin(), expected.end(), T(-7));
+
+            std::vector<T> out(n + off);
+            T* const dst = out.data() + off;
+            const auto it = tcb::iota(tcb::streaming_store(dst, 0), dst + n, T(-7));
+            REQUIRE(it.base() == dst + n);
+            REQUIRE(std::vector<T>(dst, dst + n) == expected);
+        }
+    }
+}
+
+}
+
+TEST_CASE("partial_sum with streaming stores")
+{
+    for_each_isa([] {
+        test_partial_sum<int>();
+        test_partial_sum<std::int64_t>();
+    });
+    test_partial_sum<std::int16_t>();
+    test_partial_sum<float>();
+    test_partial_sum<double>();
+}
+
+TEST_CASE("adjacent_difference with streaming stores")
+{
+    test_adjacent_difference<int>();
+    test_adjacent_difference<std::int64_t>();
+    test_adjacent_difference<std::int8_t>();
+    test_adjacent_difference<double>();
+}
+
+TEST_CASE("iota with streaming stores")
+{
+    test_iota<int>();
+    test_iota<std::int64_t>();
+    test_iota<unsigned char>();
+    test_iota<double>();
+}
+
+TEST_CASE("streaming_store falls back to ordinary stores")
+{
+    const auto in = make_input<int>(1000);
+
+    // Below the (default) threshold
+    {
+        std::vector<int> out(in.size());
+        std::vector<int> expected(in.size());
+        std::partial_sum(in.begin(), in.end(), expected.begin());
+        const auto res = tcb::partial_sum(in.data(), in.data() + in.size(),
+                                          tcb::streaming_store(out.data()));
+        REQUIRE(res.out.base() == out.data() + out.size());
+        REQUIRE(out == expected);
+    }
+
+    // A non-default operation
+    {
+        std::vector<int> out(in.size());
+        std::vector<int> expected(in.size());
+        std::partial_sum(in.begin(), in.end(), expected.begin(), std::multiplies<>{});
+        const auto res = tcb::partial_sum(in.data(), in.data() + in.size(),
+                                          tcb::streaming_store(out.data(), 0),
+                                          std::multiplies<>{});
+        REQUIRE(res.out.base() == out.data() + out.size());
+        REQUIRE(out == expected);
+    }
+
+    // A non-contiguous input
+    {
+        std::vector<int> out(in.size());
+        std::vector<int> expected(in.size());
+        std::adjacent_difference(in.begin(), in.end(), expected.begin());
+        auto src = in | tcb::rng::views::transform([](int i) { return i; });
+        const auto res = tcb::adjacent_difference(src, tcb::streaming_store(out.data(), 0));
+        REQUIRE(res.out.base() == out.data() + out.size());
+        REQUIRE(out == expected);
+    }
+
+    // Empty input
+    {
+        int* p = nullptr;
+        const auto res = tcb::partial_sum(p, p, tcb::streaming_store(p, 0));
+        REQUIRE(res.out.base() == nullptr);
+    }
+}
+
+TEST_CASE("streaming_store can be applied to a contiguous range")
+{
+    std::array<int, 300> arr{};
+    const auto first = tcb::streaming_store(arr, 0);
+    REQUIRE(first.base() == arr.data());
+    const auto it = tcb::iota(first, arr.data() + arr.size(), 1);
+    REQUIRE(it == arr.data() + arr.size());
+    REQUIRE(tcb::accumulate(arr, 0) == 300 * 301 / 2);
+
+    // The output iterator remains usable with ordinary algorithms
+    auto out = tcb::streaming_store(arr);
+    *out++ = 42;
+    REQUIRE(arr[0] == 42);
+    REQUIRE(out.base() == arr.data() + 1);
+}
@@ -0,0 +1,296 @@
+// numeric_ranges.hpp
+//
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <numeric_ranges.hpp>
+#include "catch.hpp"
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace rng = tcb::rng;
+
+namespace {
+
+template <typename T>
+std::vector<T> make_matrix(std::size_t rows, std::size_t cols)
+{
+    std::vector<T> vec;
+    for (std::size_t i = 0; i < rows * cols; ++i) {
+        vec.push_back(static_cast<T>(static_cast<int>(i * 37 % 101) - 50));
+    }
+    return vec;
+}
+
+template <typename T>
+std::vector<T> copy_of(tcb::strided_span<const T> s)
+{
+    std::vector<T> vec;
+    for (const T& x : s) {
+        vec.push_back(x);
+    }
+    return vec;
+}
+
+}
+
+static_assert(rng::random_access_range<tcb::strided_span<int>>);
+static_assert(rng::sized_range<tcb::strided_span<int>>);
+static_assert(rng::view<tcb::strided_span<int>>);
+static_assert(rng::borrowed_range<tcb::strided_span<int>>);
+
+TEST_CASE("strided_span yields every stride'th element")
+{
+    int arr[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    const tcb::strided_span<int> s(arr + 1, 3, 3);
+    REQUIRE(s.size() == 3);
+    REQUIRE(s.stride() == 3);
+    REQUIRE(s.data() == arr + 1);
+    REQUIRE(s[2] == 7);
+    REQUIRE(copy_of<int>(s) == std::vector<int>{1, 4, 7});
+
+    auto it = s.begin();
+    REQUIRE(it.stride() == 3);
+    REQUIRE(it[1] == 4);
+    REQUIRE(*(it + 2) == 7);
+    REQUIRE(s.end() - it == 3);
+    REQUIRE(it < s.end());
+    ++it;
+    *it = 40;
+    REQUIRE(arr[4] == 40);
+
+    const tcb::strided_span<const int> backwards(arr + 9, 4, -2);
+    REQUIRE(copy_of(backwards) == std::vector<int>{9, 7, 5, 3});
+
+    const tcb::strided_span<int> empty;
+    REQUIRE(empty.begin() == empty.end());
+    REQUIRE(tcb::accumulate(empty, 5) == 5);
+}
+
+TEST_CASE("matrix_view rows and columns")
+{
+    auto data = make_matrix<double>(4, 6);
+    // The middle 4x3 block, as a view into the 4x6 matrix
+    const tcb::matrix_view<const double> m(data.data() + 2, 4, 3, 6);
+
+    REQUIRE(m.rows() == 4);
+    REQUIRE(m.cols() == 3);
+    REQUIRE(m(1, 2) == data[1 * 6 + 4]);
+    REQUIRE(copy_of(m.row(3)) == std::vector<double>(data.begin() + 20, data.begin() + 23));
+    REQUIRE(copy_of(m.column(1)) == std::vector<double>{data[3], data[9], data[15], data[21]});
+}
+
+TEST_CASE("accumulate and reduce of strided spans")
+{
+    const std::size_t rows = 1000;
+    const std::size_t cols = 7;
+    const auto ints = make_matrix<int>(rows, cols);
+    const auto doubles = make_matrix<double>(rows, cols);
+    const tcb::matrix_view<const int> mi(ints.data(), rows, cols);
+    const tcb::matrix_view<const double> md(doubles.data(), rows, cols);
+
+    for (std::size_t j = 0; j < cols; ++j) {
+        const auto col = copy_of(mi.column(j));
+        REQUIRE(tcb::accumulate(mi.column(j), 3L) == tcb::accumulate(col, 3L));
+        REQUIRE(tcb::reduce(mi.column(j), 0) == tcb::accumulate(col, 0));
+        REQUIRE(tcb::accumulate(mi.column(j).begin() + 5, mi.column(j).end(), 0) ==
+                tcb::accumulate(col.begin() + 5, col.end(), 0));
+
+        const auto dcol = copy_of(md.column(j));
+        REQUIRE(tcb::accumulate(md.column(j), 0.5) == tcb::accumulate(dcol, 0.5));
+        REQUIRE(tcb::reduce(md.column(j), 0.5) == tcb::reduce(dcol, 0.5));
+    }
+
+    // Integer lanes wrap, as elsewhere
+    const std::vector<std::int64_t> big{INT64_MAX, 0, 1, 0};
+    REQUIRE(tcb::reduce(tcb::strided_span<const std::int64_t>(big.data(), 2, 2),
+                        std::int64_t{0}) == INT64_MIN);
+}
+
+TEST_CASE("inner_product of strided spans")
+{
+    const std::size_t rows = 500;
+    const std::size_t cols = 5;
+    const auto doubles = make_matrix<double>(rows, cols);
+    const auto ints = make_matrix<int>(rows, cols);
+    const tcb::matrix_view<const double> md(doubles.data(), rows, cols);
+    const tcb::matrix_view<const int> mi(ints.data(), rows, cols);
+    const auto weights = make_matrix<double>(rows, 1);
+
+    const auto c0 = copy_of(md.column(0));
+    const auto c3 = copy_of(md.column(3));
+    REQUIRE(tcb::inner_product(md.column(0), md.column(3), 1.0) ==
+            tcb::inner_product(c0, c3, 1.0));
+    REQUIRE(tcb::inner_product(md.column(3), weights, 0.0) ==
+            tcb::inner_product(c3, weights, 0.0));
+    REQUIRE(tcb::inner_product(weights, md.column(3), 0.0) ==
+            tcb::inner_product(weights, c3, 0.0));
+    REQUIRE(tcb::transform_reduce(md.column(0), md.column(3), 0.0) ==
+            tcb::transform_reduce(c0, c3, 0.0));
+    REQUIRE(tcb::inner_product(md.row(2), md.row(4), 0.0) ==
+            tcb::inner_product(copy_of(md.row(2)), copy_of(md.row(4)), 0.0));
+
+    const auto i1 = copy_of(mi.column(1));
+    const auto i4 = copy_of(mi.column(4));
+    REQUIRE(tcb::inner_product(mi.column(1), mi.column(4), 0L) ==
+            tcb::inner_product(i1, i4, 0L));
+
+    // The shorter range bounds the result
+    const tcb::strided_span<const double> part(doubles.data(), 10, 5);
+    REQUIRE(tcb::inner_product(part, weights, 0.0) ==
+            tcb::inner_product(copy_of(part), weights, 0.0));
+
+    // Each product is formed as std::multiplies<> forms it: unsigned *
+    // unsigned wraps in 32 bits, and float * float is rounded to float,
+    // before being added to a wider init
+    std::vector<std::uint32_t> big(rows * cols);
+    for (std::size_t k = 0; k < big.size(); ++k) {
+        big[k] = 65536u + static_cast<std::uint32_t>(k % 7);
+    }
+    const tcb::matrix_view<const std::uint32_t> mu(big.data(), rows, cols);
+    const auto u0 = copy_of(mu.column(0));
+    const auto u2 = copy_of(mu.column(2));
+    REQUIRE(tcb::inner_product(mu.column(0), mu.column(2), 5LL) ==
+            std::inner_product(u0.begin(), u0.end(), u2.begin(), 5LL));
+    REQUIRE(tcb::transform_reduce(mu.column(0), mu.column(2), 5LL) ==
+            std::inner_product(u0.begin(), u0.end(), u2.begin(), 5LL));
+
+    std::vector<float> floats(rows * cols);
+    for (std::size_t k = 0; k < floats.size(); ++k) {
+        floats[k] = 1.1f + 0.1f * static_cast<float>(k % 3);
+    }
+    const tcb::matrix_view<const float> mf(floats.data(), rows, cols);
+    const auto f1 = copy_of(mf.column(1));
+    double fdot = 0.0;
+    for (float x : f1) {
+        fdot += static_cast<double>(x * x);
+    }
+    REQUIRE(tcb::transform_reduce(mf.column(1), mf.column(1), 0.0) == fdot);
+}
+
+TEST_CASE("partial_sum of a strided span")
+{
+    auto data = make_matrix<int>(100, 3);
+    tcb::matrix_view<int> m(data.data(), 100, 3);
+
+    const auto col = copy_of<int>(m.column(2));
+    std::vector<int> expected(col.size());
+    tcb::partial_sum(col, expected.begin());
+
+    std::vector<int> out(col.size());
+    tcb::partial_sum(m.column(2), out.begin());
+    REQUIRE(out == expected);
+
+    // In place, down a column
+    tcb::partial_sum(m.column(2), m.column(2).begin());
+    REQUIRE(copy_of<int>(m.column(2)) == expected);
+}
+
+namespace {
+
+struct record {
+    std::int64_t id;
+    double price;
+    float weight;
+    std::int32_t quantity;
+    char padding[40];
+};
+
+struct base_row {
+    double value;
+};
+
+struct derived_row : base_row {
+    double other;
+};
+
+// 9 bytes, which is not a multiple of sizeof(double)
+#pragma pack(push, 1)
+struct packed_row {
+    double value;
+    char tag;
+};
+#pragma pack(pop)
+
+struct point3 {
+    float x, y, z;
+};
+
+std::vector<record> make_records(std::size_t n)
+{
+    std::vector<record> recs(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        recs[i].id = static_cast<std::int64_t>(i);
+        recs[i].price = static_cast<double>(i % 13) * 0.25;
+        recs[i].weight = static_cast<float>(i % 7);
+        recs[i].quantity = static_cast<std::int32_t>(i % 5) - 2;
+    }
+    return recs;
+}
+
+}
+
+TEST_CASE("accumulate and reduce of a field of an array of structs")
+{
+    const auto recs = make_records(1001);
+
+    std::int64_t ids = 0;
+    long quantities = 0;
+    double prices = 0;
+    for (const auto& r : recs) {
+        ids += r.id;
+        quantities += r.quantity;
+        prices += r.price;
+    }
+
+    REQUIRE(tcb::accumulate(recs, std::int64_t{0}, std::plus<>{}, &record::id) == ids);
+    REQUIRE(tcb::reduce(recs, 0L, std::plus<>{}, &record::quantity) == quantities);
+    REQUIRE(tcb::accumulate(recs, 0.0, std::plus<>{}, &record::price) == prices);
+    REQUIRE(tcb::reduce(recs, 0.0, std::plus<>{}, &record::price) == Approx(prices));
+    REQUIRE(tcb::accumulate(recs.begin() + 1, recs.begin() + 1, 3.0, std::plus<>{},
+                            &record::price) == 3.0);
+
+    std::vector<derived_row> rows(100);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        rows[i].value = static_cast<double>(i);
+        rows[i].other = -1.0;
+    }
+    REQUIRE(tcb::reduce(rows, 0.0, std::plus<>{}, &base_row::value) == 4950.0);
+
+    std::vector<packed_row> packed(101);
+    for (std::size_t i = 0; i < packed.size(); ++i) {
+        packed[i].value = static_cast<double>(i);
+        packed[i].tag = 'x';
+    }
+    REQUIRE(tcb::reduce(packed, 0.0, std::plus<>{}, &packed_row::value) == 5050.0);
+
+    std::vector<point3> points(37);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        points[i] = {static_cast<float>(i), -1.0f, 2.0f};
+    }
+    REQUIRE(tcb::reduce(points, 0.0, std::plus<>{}, &point3::x) == 666.0);
+    REQUIRE(tcb::transform_reduce(points, points, 0.0, std::plus<>{}, std::multiplies<>{},
+                                  &point3::x, &point3::z) == 1332.0);
+}
+
+TEST_CASE("inner_product of fields of arrays of structs")
+{
+    const auto recs = make_records(777);
+
+    double expected = 0;
+    for (const auto& r : recs) {
+        expected += r.price * r.weight;
+    }
+    REQUIRE(tcb::transform_reduce(recs, recs, 0.0, std::plus<>{}, std::multiplies<>{},
+                                  &record::price, &record::weight) == Approx(expected));
+
+    std::vector<double> weights(recs.size(), 2.0);
+    REQUIRE(tcb::inner_product(recs, weights, 0.0, std::plus<>{}, std::multiplies<>{},
+                               &record::price) ==
+            tcb::inner_product(weights, recs, 0.0, std::plus<>{}, std::multiplies<>{},
+                               {}, &record::price));
+}
@@ -112,9 +112,9 @@ class output_iterator
 
 	template <class U> friend class output_iterator;
 public:
-	using difference_type = tcb::rng::iter_difference_t<It>;
+	using difference_type = tcb::_std::iter_difference_t<It>;
 	using pointer = It;
-	using reference = tcb::rng::iter_reference_t<It>;
+	using reference = tcb::_std::iter_reference_t<It>;
 
 	constexpr It base() const {return it_;}
 
@@ -140,10 +140,10 @@ class InputIterator
 	template <class U> friend class InputIterator;
 public:
 	typedef std::input_iterator_tag iterator_category;
-	typedef tcb::rng::iter_value_t<It>      value_type;
-	typedef tcb::rng::iter_difference_t<It> difference_type;
+	typedef tcb::_std::iter_value_t<It>      value_type;
+	typedef tcb::_std::iter_difference_t<It> difference_type;
 	typedef It                       pointer;
-	typedef tcb::rng::iter_reference_t<It>  reference;
+	typedef tcb::_std::iter_reference_t<It>  reference;
 
 	constexpr It base() const {return it_;}
 
@@ -192,10 +192,10 @@ class ForwardIterator
 	template <class U> friend class ForwardIterator;
 public:
 	typedef std::forward_iterator_tag iterator_category;
-	typedef tcb::rng::iter_value_t<It>        value_type;
-	typedef tcb::rng::iter_difference_t<It>   difference_type;
+	typedef tcb::_std::iter_value_t<It>        value_type;
+	typedef tcb::_std::iter_difference_t<It>   difference_type;
 	typedef It                         pointer;
-	typedef tcb::rng::iter_reference_t<It>    reference;
+	typedef tcb::_std::iter_reference_t<It>    reference;
 
 	constexpr It base() const {return it_;}
 
@@ -244,10 +244,10 @@ class BidirectionalIterator
 	template <class U> friend class BidirectionalIterator;
 public:
 	typedef std::bidirectional_iterator_tag iterator_category;
-	typedef tcb::rng::iter_value_t<It>              value_type;
-	typedef tcb::rng::iter_difference_t<It>         difference_type;
+	typedef tcb::_std::iter_value_t<It>              value_type;
+	typedef tcb::_std::iter_difference_t<It>         difference_type;
 	typedef It                               pointer;
-	typedef tcb::rng::iter_reference_t<It>          reference;
+	typedef tcb::_std::iter_reference_t<It>          reference;
 
 	constexpr It base() const {return it_;}
 
@@ -293,10 +293,10 @@ class RandomAccessIterator
 	template <class U> friend class RandomAccessIterator;
 public:
 	typedef std::random_access_iterator_tag iterator_category;
-	typedef tcb::rng::iter_value_t<It>              value_type;
-	typedef tcb::rng::iter_difference_t<It>         difference_type;
+	typedef tcb::_std::iter_value_t<It>              value_type;
+	typedef tcb::_std::iter_difference_t<It>         difference_type;
 	typedef It                               pointer;
-	typedef tcb::rng::iter_reference_t<It>          reference;
+	typedef tcb::_std::iter_reference_t<It>          reference;
 
 	constexpr It base() const {return it_;}
 
@@ -385,7 +385,7 @@ operator>=(const RandomAccessIterator<T>& x, const RandomAccessIterator<U>& y)
 
 template <class T, class U>
 constexpr
-tcb::rng::iter_difference_t<T>
+tcb::_std::iter_difference_t<T>
 operator-(const RandomAccessIterator<T>& x, const RandomAccessIterator<U>& y)
 {
 	return x.base() - y.base();